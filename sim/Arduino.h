@@ -0,0 +1,165 @@
+/*
+ * Minimal Arduino core for the host simulator build
+ */
+#ifndef _SIM_Arduino_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "sim.h"
+
+  #define _SIM_Arduino_H_ 1
+
+  #define HEX 16
+  #define DEC 10
+
+  #define INPUT 0x01
+  #define OUTPUT 0x03
+  #define INPUT_PULLUP 0x05
+  #define LOW 0x0
+  #define HIGH 0x1
+
+  #define RISING 0x01
+  #define FALLING 0x02
+  #define CHANGE 0x03
+
+  #define IRAM_ATTR
+  #define digitalPinToInterrupt(p) (p)
+
+  #define ESP_OK 0
+  #define portTICK_PERIOD_MS 1
+  #define portTICK_RATE_MS portTICK_PERIOD_MS
+
+  typedef uint8_t byte;
+  typedef int esp_err_t;
+
+  class String {
+
+    public:
+      String(const char *s = "") : m_s(s ? s : "") {
+      }
+      String(const std::string &s) : m_s(s) {
+      }
+      String(int v, unsigned char base = DEC) : m_s(fmt((long)v, base)) {
+      }
+      String(unsigned int v, unsigned char base = DEC) : m_s(fmt((unsigned long)v, base)) {
+      }
+      String(long v, unsigned char base = DEC) : m_s(fmt(v, base)) {
+      }
+      String(unsigned long v, unsigned char base = DEC) : m_s(fmt(v, base)) {
+      }
+      String(double v, unsigned char digits = 2) {
+        char b[32];
+        snprintf(b, sizeof b, "%.*f", digits, v);
+        m_s = b;
+      }
+
+      String operator+(const String &rhs) const {
+        return String(m_s + rhs.m_s);
+      }
+      String &operator+=(const String &rhs) {
+        m_s += rhs.m_s;
+        return *this;
+      }
+
+      const char *c_str() const {
+        return m_s.c_str();
+      }
+      unsigned int length() const {
+        return m_s.length();
+      }
+
+    private:
+      std::string m_s;
+
+      static std::string fmt(long v, unsigned char base) {
+        if (v < 0) {
+          return "-" + fmt((unsigned long)-v, base);
+        }
+        return fmt((unsigned long)v, base);
+      }
+
+      static std::string fmt(unsigned long v, unsigned char base) {
+        char b[8 * sizeof(long) + 1];
+        char *p = &b[sizeof b - 1];
+        *p = 0;
+        do {
+          *--p = "0123456789ABCDEF"[v % base];
+          v /= base;
+        } while (v);
+        return p;
+      }
+  };
+
+  // Serial port. Output goes to stdout unless the simulator runs with --quiet,
+  // input is fed from the --serial script. Writes take UART time either way.
+  class HardwareSerial {
+
+    public:
+      void begin(unsigned long baud);
+
+      size_t write(uint8_t c);
+      size_t write(const uint8_t *data, size_t len);
+      int available();
+      int read();
+
+      size_t print(const char *s) {
+        return write((const uint8_t *)s, strlen(s));
+      }
+      size_t print(const String &s) {
+        return print(s.c_str());
+      }
+      size_t print(char c) {
+        return write((uint8_t)c);
+      }
+      size_t print(int v, int base = DEC) {
+        return print(String((long)v, base));
+      }
+      size_t print(unsigned int v, int base = DEC) {
+        return print(String((unsigned long)v, base));
+      }
+      size_t print(long v, int base = DEC) {
+        return print(String(v, base));
+      }
+      size_t print(unsigned long v, int base = DEC) {
+        return print(String(v, base));
+      }
+      size_t print(double v, int digits = 2) {
+        return print(String(v, digits));
+      }
+
+      template <typename T> size_t println(T v) {
+        return print(v) + println();
+      }
+      template <typename T> size_t println(T v, int fmt) {
+        return print(v, fmt) + println();
+      }
+      size_t println() {
+        return print("\r\n");
+      }
+  };
+
+  extern HardwareSerial Serial;
+
+  unsigned long millis();
+  unsigned long micros();
+  void delay(uint32_t ms);
+  void delayMicroseconds(uint32_t us);
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int digitalRead(uint8_t pin);
+
+  // Handlers run from inside whatever call advances the virtual clock
+  void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode);
+  void detachInterrupt(uint8_t pin);
+
+  double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+  void ledcAttachPin(uint8_t pin, uint8_t channel);
+  void ledcWrite(uint8_t channel, uint32_t duty);
+
+#endif
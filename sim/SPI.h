@@ -0,0 +1,10 @@
+/*
+ * SPI is driven entirely by the TFT_eSPI stand-in in the simulator
+ */
+#ifndef _SIM_SPI_H_
+
+#include "Arduino.h"
+
+  #define _SIM_SPI_H_ 1
+
+#endif
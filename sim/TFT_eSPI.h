@@ -0,0 +1,229 @@
+/*
+ * TFT_eSPI stand-in: a memory framebuffer behind a modelled SPI link
+ *
+ * Pixels land in an RGB565 framebuffer in the order the panel would read them
+ * off the wire, so byte order mistakes show up in the dumps. Every transfer is
+ * charged SPI_FREQUENCY bus time on the virtual clock; DMA pushes run in the
+ * background until dmaWait() or the next push has to wait for them.
+ */
+#ifndef _SIM_TFT_eSPI_H_
+
+#include "Arduino.h"
+
+  #define _SIM_TFT_eSPI_H_ 1
+
+  // The ST7796 driver defines its native portrait geometry, as the real library does
+  #ifdef ST7796_DRIVER
+    #undef TFT_WIDTH
+    #undef TFT_HEIGHT
+    #define TFT_WIDTH 320
+    #define TFT_HEIGHT 480
+  #endif
+
+  #ifndef SPI_FREQUENCY
+    #define SPI_FREQUENCY 27000000
+  #endif
+
+  #define TFT_BLACK 0x0000
+
+  class TFT_eSPI {
+
+    public:
+      TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT) : m_initWidth(w), m_initHeight(h), m_width(w), m_height(h) {
+        m_fb = new uint16_t[(size_t)w * h]();
+        m_written = new bool[(size_t)w * h]();
+        m_unwritten = (uint32_t)w * h;
+      }
+
+      ~TFT_eSPI() {
+        delete[] m_fb;
+        delete[] m_written;
+      }
+
+      void begin() {
+        init();
+      }
+
+      void init() {
+        setRotation(0);
+        m_window = {0, 0, (int32_t)m_width - 1, (int32_t)m_height - 1};
+      }
+
+      void setRotation(uint8_t r) {
+        m_rotation = r & 3;
+        m_width = (m_rotation & 1) ? m_initHeight : m_initWidth;
+        m_height = (m_rotation & 1) ? m_initWidth : m_initHeight;
+      }
+
+      uint8_t getRotation() {
+        return m_rotation;
+      }
+
+      int16_t width() {
+        return m_width;
+      }
+
+      int16_t height() {
+        return m_height;
+      }
+
+      void setSwapBytes(bool swap) {
+        m_swapBytes = swap;
+      }
+
+      bool getSwapBytes() {
+        return m_swapBytes;
+      }
+
+      bool initDMA(bool ctrl_cs = false) {
+        (void)ctrl_cs;
+        m_dmaEnabled = true;
+        return true;
+      }
+
+      void deInitDMA() {
+        dmaWait();
+        m_dmaEnabled = false;
+      }
+
+      void startWrite() {
+        m_inTransaction++;
+      }
+
+      void endWrite() {
+        if (m_inTransaction) {
+          m_inTransaction--;
+        }
+      }
+
+      void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+        // Commands can't go out while a DMA transfer holds the bus
+        dmaWait();
+        m_window = {x, y, x + w - 1, y + h - 1};
+        m_cursorX = x;
+        m_cursorY = y;
+        sim::spi_stats().windows++;
+        transmit(11, false); // CASET + 4, RASET + 4, RAMWR
+      }
+
+      void pushColors(uint16_t *data, uint32_t len, bool swap = true) {
+        dmaWait();
+        for (uint32_t i = 0; i < len; i++) {
+          plot(swap ? data[i] : bswap(data[i]));
+        }
+        sim::spi_stats().transfers++;
+        transmit((uint64_t)len * 2, false);
+      }
+
+      void pushPixels(const void *data, uint32_t len) {
+        pushColors((uint16_t *)data, len, m_swapBytes);
+      }
+
+      void pushPixelsDMA(uint16_t *image, uint32_t len) {
+        if (len == 0 || !m_dmaEnabled) {
+          return;
+        }
+        dmaWait();
+        // Same in-place swap the real library does before queueing the transfer
+        if (m_swapBytes) {
+          for (uint32_t i = 0; i < len; i++) {
+            image[i] = bswap(image[i]);
+          }
+        }
+        for (uint32_t i = 0; i < len; i++) {
+          plot(bswap(image[i]));
+        }
+        sim::spi_stats().transfers++;
+        transmit((uint64_t)len * 2, true);
+      }
+
+      void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *image) {
+        setAddrWindow(x, y, w, h);
+        pushPixelsDMA(image, w * h);
+      }
+
+      bool dmaBusy() {
+        sim::account_cpu();
+        return sim::now_us() < m_dmaDoneUs;
+      }
+
+      void dmaWait() {
+        sim::account_cpu();
+        uint64_t now = sim::now_us();
+        if (now < m_dmaDoneUs) {
+          sim::spi_stats().wait_us += m_dmaDoneUs - now;
+          sim::advance_us(m_dmaDoneUs - now);
+        }
+      }
+
+      // Panel contents, RGB565 as the controller decoded it from the wire
+      const uint16_t *framebuffer() const {
+        return m_fb;
+      }
+
+      bool dump(const char *path) const;
+
+    private:
+      typedef struct Window {
+        int32_t x1, y1, x2, y2;
+      } Window;
+
+      int16_t m_initWidth;
+      int16_t m_initHeight;
+      int16_t m_width;
+      int16_t m_height;
+      uint8_t m_rotation = 0;
+
+      uint16_t *m_fb;
+      bool *m_written;      // Pixels sent at least once
+      uint32_t m_unwritten;
+      Window m_window = {0, 0, 0, 0};
+      int32_t m_cursorX = 0;
+      int32_t m_cursorY = 0;
+
+      bool m_swapBytes = false;
+      bool m_dmaEnabled = false;
+      uint32_t m_inTransaction = 0;
+      uint64_t m_dmaDoneUs = 0;
+
+      static uint16_t bswap(uint16_t c) {
+        return (uint16_t)((c << 8) | (c >> 8));
+      }
+
+      // `c` is the 16-bit word in wire order: first byte on the bus in the high half
+      void plot(uint16_t c) {
+        if (m_cursorX >= 0 && m_cursorX < m_width && m_cursorY >= 0 && m_cursorY < m_height) {
+          size_t i = (size_t)m_cursorY * m_width + m_cursorX;
+          m_fb[i] = c;
+          if (!m_written[i]) {
+            m_written[i] = true;
+            m_unwritten--;
+          }
+        }
+        if (++m_cursorX > m_window.x2) {
+          m_cursorX = m_window.x1;
+          if (++m_cursorY > m_window.y2) {
+            m_cursorY = m_window.y1;
+          }
+        }
+      }
+
+      // Blocking transfers hold the CPU, DMA ones only the bus
+      void transmit(uint64_t bytes, bool dma) {
+        uint64_t us = (bytes * 8 * 1000000 + SPI_FREQUENCY - 1) / SPI_FREQUENCY;
+        sim::SpiStats &stats = sim::spi_stats();
+        stats.bytes += bytes;
+        stats.busy_us += us;
+        if (m_unwritten == 0 && stats.first_full_us == 0) {
+          stats.first_full_us = sim::now_us() + us; // The transfer that sent the last new pixel
+        }
+        if (dma) {
+          m_dmaDoneUs = sim::now_us() + us;
+        } else {
+          stats.wait_us += us;
+          sim::advance_us(us);
+        }
+      }
+  };
+
+#endif
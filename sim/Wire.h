@@ -0,0 +1,51 @@
+/*
+ * I2C stand-in routing transactions to the simulator's scripted devices
+ */
+#ifndef _SIM_Wire_H_
+
+#include "Arduino.h"
+
+  #define _SIM_Wire_H_ 1
+
+  #define I2C_BUFFER_LENGTH 128
+
+  class TwoWire {
+
+    public:
+      bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+      bool setClock(uint32_t frequency);
+
+      // Kept for the caller; transfers here never stall, an absent device NACKs
+      void setTimeOut(uint16_t timeOutMillis) {
+        m_timeOut = timeOutMillis;
+      }
+
+      uint16_t getTimeOut() {
+        return m_timeOut;
+      }
+
+      void beginTransmission(int address);
+      size_t write(uint8_t data);
+      size_t write(const uint8_t *data, size_t len);
+      uint8_t endTransmission(bool sendStop = true);
+
+      uint8_t requestFrom(int address, int quantity);
+      int available();
+      int read();
+      size_t readBytes(uint8_t *buffer, size_t len);
+
+    private:
+      uint16_t m_timeOut = 50;
+      bool m_locked = false; // Held from beginTransmission() to endTransmission(), as on the target
+      uint8_t m_txAddress = 0;
+      uint8_t m_txBuffer[I2C_BUFFER_LENGTH];
+      size_t m_txLength = 0;
+
+      uint8_t m_rxBuffer[I2C_BUFFER_LENGTH];
+      size_t m_rxLength = 0;
+      size_t m_rxIndex = 0;
+  };
+
+  extern TwoWire Wire;
+
+#endif
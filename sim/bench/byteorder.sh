@@ -0,0 +1,26 @@
+#!/bin/sh
+# Byte order check: renders the splash, main and settings screens with the
+# swapped and unswapped host builds and fails unless the frames are identical.
+# Usage: byteorder.sh [swapped program] [unswapped program]
+dir=$(dirname "$0")
+swap=${1:-.pio/build/native/program}
+noswap=${2:-.pio/build/native_noswap/program}
+out=$(mktemp -d) || exit 1
+trap 'rm -rf "$out"' EXIT
+
+status=0
+# splash (the indexed icon; no screen uses a PNG), main, settings opened by spinbox_taps.txt
+for run in "splash 1000" "main 3400" "settings 6000"; do
+  set -- $run
+  for build in swap noswap; do
+    eval program=\$$build
+    "$program" --quiet --ms "$2" --touch "$dir/spinbox_taps.txt" --dump "$out/$1-$build.ppm" 2>/dev/null || exit 1
+  done
+  if cmp -s "$out/$1-swap.ppm" "$out/$1-noswap.ppm"; then
+    echo "$1: identical"
+  else
+    echo "$1: frames differ"
+    status=1
+  fi
+done
+exit $status
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Main loop cost with host CPU time charged to the virtual clock, for two
+# builds: loop() calls, wakeups, busy share and LVGL idle when left untouched,
+# then the same while spinbox_taps.txt plays, with p50/p99/max of the input
+# latency histograms from prof.
+# Usage: idle.sh <before program> [after program] [cpu scale]
+# A "-" is a line the program did not print: it was not built against this sim/.
+dir=$(dirname "$0")
+before=$1
+after=${2:-.pio/build/native/program}
+scale=${3:-1}
+[ -n "$before" ] || { echo "usage: $0 <before program> [after program] [cpu scale]"; exit 2; }
+out=$(mktemp -d) || exit 1
+trap 'rm -rf "$out"' EXIT
+
+for build in before after; do
+  eval program=\$$build
+  "$program" --quiet --ms 20000 --cpu-scale "$scale" >/dev/null 2>"$out/idle" || exit 1
+  "$program" --quiet --ms 11000 --cpu-scale "$scale" --touch "$dir/spinbox_taps.txt" \
+    --serial-end "$(printf 'prof\n')" >"$out/prof" 2>"$out/taps" || exit 1
+  for run in idle taps; do
+    awk -v label="$build $run" '
+      BEGIN { calls = wakeups = busy = lvidle = "-" }
+      $1 == "loop()" { calls = $3; sub(/,$/, "", calls); lvidle = $6 }
+      $1 == "main" && $2 == "loop" { wakeups = $3; busy = $5 }
+      END { printf "%-12s %s loop() calls, %s wakeups/s, %s busy, lvgl idle %s\n", label, calls, wakeups, busy, lvidle }' "$out/$run"
+  done
+  # name count p50 p95 p99 max, in us
+  awk -v label="$build taps" '
+    $1 == "touch_age" || $1 == "tap_event" || $1 == "photon" {
+      printf "%-12s %-9s p50 %s, p99 %s, max %s us over %s\n", label, $1, $3, $5, $6, $2; found++
+    }
+    END { if (!found) printf "%-12s no prof histograms\n", label }' "$out/prof"
+done
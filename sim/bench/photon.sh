@@ -0,0 +1,16 @@
+#!/bin/sh
+# Touch-to-photon benchmark: replays spinbox_taps.txt on the host build and
+# fails if the photon p95 is over budget. Usage: photon.sh [program] [p95 us]
+dir=$(dirname "$0")
+program=${1:-.pio/build/native/program}
+budget=${2:-100000}
+
+report=$("$program" --quiet --ms 11000 --touch "$dir/spinbox_taps.txt" --serial-end "$(printf 'prof\n')" 2>/dev/null) || exit 1
+echo "$report" | grep -E '^(name|tap_event|photon)'
+
+# name count p50 p95 p99 max
+echo "$report" | awk -v budget="$budget" '
+  $1 == "photon" { found = 1; if ($2 == 0 || $4 > budget) bad = 1 }
+  END {
+    if (!found || bad) { print "photon p95 over " budget " us or no probes"; exit 1 }
+  }'
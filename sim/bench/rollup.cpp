@@ -0,0 +1,139 @@
+/*
+ * RollupStore against a brute-force recompute, on the host
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc sim/bench/rollup.cpp -o rollup && ./rollup [seconds of samples]
+ *
+ * Feeds random one-second samples, then recomputes every retained bucket of
+ * every level straight from the samples. Exits non-zero on any mismatch in
+ * sum, min, max, count, mean or the bits add() returns, and checks the chart
+ * windows read back from every level. A second pass uses samples across the
+ * whole ROLLUP_VALUE_MAX range, and out of range ones must come back clamped.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "RollupStore.h"
+
+// Seconds per bucket of each level, as the chart intervals
+static const uint32_t seconds[ROLLUP_LEVELS] = {1, 10, 60, 600, 1800, 3600, 7200};
+
+// As the firmware: a day of 1 minute buckets, a chart's worth of the others
+static const uint16_t capacity[ROLLUP_LEVELS] = {24, 24, 1440, 24, 24, 24, 24};
+static Rollup storage[6 * 24 + 1440];
+
+static uint32_t errors = 0;
+
+static void fail(const char *what, uint8_t level, uint32_t bucket) {
+  if (errors++ < 10) {
+    printf("level %u bucket %u: %s\n", level, bucket, what);
+  }
+}
+
+// Rounded to nearest, halves away from zero
+static int32_t mean(int64_t sum, uint32_t count) {
+  double m = (double)sum / count;
+  return (int32_t)(m < 0 ? m - 0.5 : m + 0.5);
+}
+
+static void check(const RollupStore &store, const std::vector<int32_t> &samples) {
+  for (uint8_t l = 0; l < ROLLUP_LEVELS; l++) {
+    const SeriesRing<Rollup> &level = store.level(l);
+    uint32_t closed = samples.size() / seconds[l];
+    uint32_t retained = closed < capacity[l] ? closed : capacity[l];
+    if (level.size() != retained) {
+      fail("wrong bucket count", l, 0);
+      continue;
+    }
+    for (uint32_t back = 0; back < retained; back++) {
+      uint32_t first = (closed - 1 - back) * seconds[l];
+      int64_t sum = 0;
+      int32_t min = INT32_MAX;
+      int32_t max = INT32_MIN;
+      for (uint32_t i = first; i < first + seconds[l]; i++) {
+        sum += samples[i];
+        min = samples[i] < min ? samples[i] : min;
+        max = samples[i] > max ? samples[i] : max;
+      }
+      const Rollup &r = level.fromNewest(back);
+      if (r.sum != sum || r.min != min || r.max != max || r.count != seconds[l]) {
+        fail("aggregate differs", l, back);
+      } else if (RollupStore::mean(r) != mean(sum, seconds[l])) {
+        fail("mean differs", l, back);
+      }
+    }
+  }
+}
+
+// Chart windows at every offset, including ones reaching past the oldest bucket
+static void check_windows(const RollupStore &store) {
+  const Rollup fill = {0, 0, 0, 0};
+  Rollup slice[24];
+  for (uint8_t l = 0; l < ROLLUP_LEVELS; l++) {
+    const SeriesRing<Rollup> &level = store.level(l);
+    for (uint32_t back = 0; back <= level.size(); back++) {
+      level.window(slice, 24, back, fill);
+      for (uint32_t i = 0; i < 24; i++) {
+        uint32_t age = back + 23 - i;
+        const Rollup &want = age < level.size() ? level.fromNewest(age) : fill;
+        if (slice[i].sum != want.sum || slice[i].count != want.count) {
+          fail("window differs", l, back);
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t total = argc > 1 ? strtoul(argv[1], NULL, 10) : 24 * 7200 + 4321;
+  RollupStore store(storage, capacity);
+  std::vector<int32_t> samples;
+  srand(1);
+
+  // A pH-like random walk in hundredths that also goes negative
+  int32_t value = 0;
+  for (uint32_t t = 0; t < total; t++) {
+    value += rand() % 41 - 20;
+    value = value < -200 ? -200 : value > 1400 ? 1400 : value;
+    samples.push_back(value);
+
+    uint8_t completed = store.add(value);
+    for (uint8_t l = 0; l < ROLLUP_LEVELS; l++) {
+      bool closes = (t + 1) % seconds[l] == 0;
+      if (((completed >> l) & 1) != closes) {
+        fail("completed bit wrong", l, t);
+      }
+    }
+  }
+  check(store, samples);
+  check_windows(store);
+
+  // Starts over from nothing after clear()
+  store.clear();
+  samples.clear();
+  for (uint32_t t = 0; t < 7200; t++) {
+    samples.push_back(rand() % 1400);
+    store.add(samples.back());
+  }
+  check(store, samples);
+
+  // Wider than int16_t, as an EC in uS/cm hundredths would be, up to the limit
+  store.clear();
+  samples.clear();
+  for (uint32_t t = 0; t < 3 * 7200; t++) {
+    samples.push_back(ROLLUP_VALUE_MAX - rand() % (2 * ROLLUP_VALUE_MAX + 1));
+    store.add(samples.back());
+  }
+  check(store, samples);
+
+  // Out of range samples are clamped, not wrapped
+  store.clear();
+  store.add(ROLLUP_VALUE_MAX + 1000);
+  store.add(INT32_MIN);
+  if (store.level(0).fromNewest(1).max != ROLLUP_VALUE_MAX || store.level(0).fromNewest(0).min != -ROLLUP_VALUE_MAX) {
+    fail("not clamped", 0, 0);
+  }
+
+  printf("%u samples, %u mismatches\n", total, errors);
+  return errors ? 1 : 0;
+}
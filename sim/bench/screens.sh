@@ -0,0 +1,22 @@
+#!/bin/sh
+# Screen memory and start-up: LVGL heap and the time the panel is first fully
+# drawn, with the main screen up and with settings opened by spinbox_taps.txt.
+# Usage: screens.sh <before program> [after program]
+# A "-" is a line the program did not print: it was not built against this sim/.
+dir=$(dirname "$0")
+before=$1
+after=${2:-.pio/build/native/program}
+[ -n "$before" ] || { echo "usage: $0 <before program> [after program]"; exit 2; }
+
+for run in "main 3400" "settings 6000"; do
+  set -- $run
+  for build in before after; do
+    eval program=\$$build
+    report=$("$program" --quiet --ms "$2" --touch "$dir/spinbox_taps.txt" 2>&1 >/dev/null) || exit 1
+    echo "$report" | awk -v run="$1" -v build="$build" '
+      BEGIN { full = used = peak = "-" }
+      $1 == "panel" { full = $4 ~ /^[0-9]+$/ ? $4 " ms" : $4 }
+      $1 == "lvgl" { used = $3; peak = $6 }
+      END { printf "%-8s %-6s first full %8s, lvgl heap %6s used, %6s peak\n", run, build, full, used, peak }'
+  done
+done
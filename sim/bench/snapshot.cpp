@@ -0,0 +1,99 @@
+/*
+ * Snapshot stress test and read cost, on the host
+ *
+ *   g++ -std=gnu++17 -O2 -pthread -Isrc sim/bench/snapshot.cpp -o snapshot && ./snapshot [seconds]
+ *
+ * A writer thread publishes frames whose fields all derive from one counter
+ * while a reader thread checks every copy it gets. Exits non-zero on a torn
+ * or out of order read.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Snapshot.h"
+
+typedef struct Frame {
+  int32_t ph;
+  int32_t ec;
+  int32_t temp;
+  uint32_t n;
+  uint8_t pad[48]; // Wider than one cache line, so a torn copy can show up
+  uint32_t check;
+} Frame;
+
+static Frame make(uint32_t n) {
+  Frame f;
+  f.ph = n * 3;
+  f.ec = n * 5;
+  f.temp = n * 7;
+  f.n = n;
+  for (unsigned i = 0; i < sizeof f.pad; i++) {
+    f.pad[i] = (uint8_t)(n + i);
+  }
+  f.check = n ^ 0xA5A5A5A5;
+  return f;
+}
+
+static bool intact(const Frame &f) {
+  Frame expect = make(f.n);
+  return f.ph == expect.ph && f.ec == expect.ec && f.temp == expect.temp && f.check == expect.check &&
+         memcmp(f.pad, expect.pad, sizeof f.pad) == 0;
+}
+
+static double read_ns(const Snapshot<Frame> &snapshot, uint32_t runs) {
+  volatile uint32_t sink = 0;
+  Frame f;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < runs; i++) {
+    sink += snapshot.read(f);
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+  Snapshot<Frame> snapshot;
+  snapshot.publish(make(1));
+
+  const uint32_t runs = 10000000;
+  double quiet_ns = read_ns(snapshot, runs);
+
+  std::atomic<bool> stop{false};
+  uint32_t published = 1;
+  std::thread writer([&] {
+    uint32_t n = 1;
+    while (!stop.load(std::memory_order_relaxed)) {
+      snapshot.publish(make(++n));
+    }
+    published = n;
+  });
+
+  uint64_t reads = 0;
+  uint64_t torn = 0;
+  uint64_t backwards = 0;
+  uint32_t last = 0;
+  std::chrono::steady_clock::time_point end =
+      std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 1000; i++) {
+      Frame f;
+      uint32_t version = snapshot.read(f);
+      torn += !intact(f) || version != f.n;
+      backwards += version < last;
+      last = version;
+      reads++;
+    }
+  }
+  double busy_ns = read_ns(snapshot, runs / 10);
+  stop = true;
+  writer.join();
+
+  printf("reads %llu, publishes %u, torn %llu, out of order %llu\n", (unsigned long long)reads, published,
+         (unsigned long long)torn, (unsigned long long)backwards);
+  printf("read %.1f ns idle, %.1f ns while publishing\n", quiet_ns, busy_ns);
+  return torn || backwards ? 1 : 0;
+}
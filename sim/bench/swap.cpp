@@ -0,0 +1,58 @@
+/*
+ * CPU cost of the software byte swap before a DMA flush, on the host
+ *
+ *   g++ -std=gnu++17 -O2 sim/bench/swap.cpp -o swap && ./swap [flushes]
+ *
+ * With LV_COLOR_16_SWAP=0 TFT_eSPI swaps every pixel of the draw buffer in
+ * place before queueing the transfer; with LV_COLOR_16_SWAP=1 the buffer goes
+ * out as rendered. Times that loop over one 480x10 draw buffer, the same size
+ * as the firmware's, and scales it to a full 480x320 frame. The host is many
+ * times faster per pixel than the ESP32; the target's figure is the "flush"
+ * stage of "prof" in the two builds.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <chrono>
+
+#define BUF_PIXELS (480 * 10)
+#define FRAME_PIXELS (480 * 320)
+
+static uint16_t buf[BUF_PIXELS];
+
+// As TFT_eSPI::pushPixelsDMA does with swapBytes set
+static void __attribute__((noinline)) swap_in_place(uint16_t *image, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    image[i] = (uint16_t)((image[i] << 8) | (image[i] >> 8));
+  }
+}
+
+static void __attribute__((noinline)) no_swap(uint16_t *image, uint32_t len) {
+  (void)image;
+  (void)len;
+}
+
+static double ns_per_flush(void (*prepare)(uint16_t *, uint32_t), uint32_t flushes) {
+  volatile uint32_t sink = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < flushes; i++) {
+    prepare(buf, BUF_PIXELS);
+    sink += buf[i % BUF_PIXELS];
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / flushes;
+}
+
+int main(int argc, char **argv) {
+  uint32_t flushes = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+  for (uint32_t i = 0; i < BUF_PIXELS; i++) {
+    buf[i] = (uint16_t)rand();
+  }
+
+  ns_per_flush(swap_in_place, flushes / 10);
+  double swapped = ns_per_flush(swap_in_place, flushes);
+  double unswapped = ns_per_flush(no_swap, flushes);
+  double frame = (double)FRAME_PIXELS / BUF_PIXELS;
+  printf("per 480x10 flush: swap %.0f ns, none %.0f ns\n", swapped, unswapped);
+  printf("per full frame:   swap %.1f us, none %.1f us\n", swapped * frame / 1000, unswapped * frame / 1000);
+  return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * Per-tick measurement path, doubles against milli-units, on the host
+ *
+ *   g++ -std=gnu++17 -O2 -Isrc sim/bench/tick.cpp -o tick && ./tick
+ *
+ * Runs TickBench from src/ both ways and prints ns per tick. The host FPU does
+ * doubles in hardware, so this understates the gap on the ESP32, where every
+ * double operation is a soft-float call; "bench tick" on Serial gives the
+ * target's cycle counts.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "TickBench.h"
+
+static double ns_per_tick(TickBench &bench, bool fixed, uint32_t ticks) {
+  volatile uint32_t sink = 0;
+  srand(1);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ticks; i++) {
+    sink += fixed ? bench.fixedTick() : bench.doubleTick();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+}
+
+int main(int argc, char **argv) {
+  uint32_t ticks = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+  static TickBench bench;
+
+  // Warm up caches and the branch predictor on both paths first
+  ns_per_tick(bench, false, ticks / 10);
+  ns_per_tick(bench, true, ticks / 10);
+
+  double doubles = ns_per_tick(bench, false, ticks);
+  double fixed = ns_per_tick(bench, true, ticks);
+  printf("per tick: double %.0f ns, fixed %.0f ns (%.1fx)\n", doubles, fixed, doubles / fixed);
+  return 0;
+}
@@ -0,0 +1,17 @@
+/*
+ * FreeRTOS tick hook stand-in, called once per virtual millisecond
+ */
+#ifndef _SIM_esp_freertos_hooks_H_
+
+#include "Arduino.h"
+
+  #define _SIM_esp_freertos_hooks_H_ 1
+
+  typedef void (*esp_freertos_tick_cb_t)(void);
+
+  static inline esp_err_t esp_register_freertos_tick_hook(esp_freertos_tick_cb_t new_tick_cb) {
+    sim::set_tick_hook(new_tick_cb);
+    return ESP_OK;
+  }
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * FreeRTOS types for the host simulator, one tick per virtual millisecond
+ */
+#ifndef _SIM_FreeRTOS_H_
+
+#include <stdint.h>
+#include "../Arduino.h"
+
+  #define _SIM_FreeRTOS_H_ 1
+
+  typedef int BaseType_t;
+  typedef unsigned int UBaseType_t;
+  typedef uint32_t TickType_t;
+  typedef void *TaskHandle_t;
+  typedef void (*TaskFunction_t)(void *);
+
+  #define pdFALSE 0
+  #define pdTRUE 1
+  #define pdFAIL 0
+  #define pdPASS 1
+  #define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+  #define configTICK_RATE_HZ 1000
+  #define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif
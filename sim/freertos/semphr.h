@@ -0,0 +1,16 @@
+/*
+ * FreeRTOS mutex stand-ins, see rtos.cpp
+ */
+#ifndef _SIM_semphr_H_
+
+#include "FreeRTOS.h"
+
+  #define _SIM_semphr_H_ 1
+
+  typedef void *SemaphoreHandle_t;
+
+  SemaphoreHandle_t xSemaphoreCreateMutex();
+  BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks);
+  BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#endif
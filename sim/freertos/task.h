@@ -0,0 +1,22 @@
+/*
+ * FreeRTOS task stand-ins. Tasks run on their own threads but in lockstep with
+ * the main loop, see rtos.cpp; the core argument is ignored.
+ */
+#ifndef _SIM_task_H_
+
+#include "FreeRTOS.h"
+
+  #define _SIM_task_H_ 1
+
+  BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                     UBaseType_t prio, TaskHandle_t *handle, BaseType_t core);
+  TickType_t xTaskGetTickCount();
+  void vTaskDelay(TickType_t ticks);
+  void vTaskDelayUntil(TickType_t *previous, TickType_t increment);
+
+  // Direct-to-task notifications as a counting semaphore
+  TaskHandle_t xTaskGetCurrentTaskHandle();
+  void xTaskNotifyGive(TaskHandle_t task);
+  uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Overdraw analyzer for the host build
+ *
+ * Every object's design callback is wrapped. Each DRAW_MAIN call adds one to
+ * every pixel of the clip area LVGL hands the object, which is the area it
+ * renders over; its time in the design callback is charged to it as well.
+ * At the start of a refresh the pending invalid areas are charged to the
+ * deepest object that contains them, taken as the one that invalidated it.
+ */
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "lvgl.h"
+#include "sim.h"
+
+// lodepng is built as C inside lv_lib_png
+#define LODEPNG_NO_COMPILE_CPP
+extern "C" {
+  #include "lodepng.h"
+}
+
+namespace sim {
+
+  typedef struct ObjStats {
+    std::string name;
+    uint32_t frames;     // Refreshes the object was drawn in
+    uint64_t drawn_px;   // Pixels covered by its draws
+    uint64_t inv_px;     // Pixels of invalid areas charged to it
+    uint32_t inv_areas;
+    double draw_us;      // Host time in its design callback
+    uint32_t last_frame;
+  } ObjStats;
+
+  typedef struct Wrapped {
+    lv_design_cb_t design;
+    size_t stats;
+  } Wrapped;
+
+  static bool enabled = false;
+  static std::unordered_map<lv_obj_t *, Wrapped> wrapped;
+  static std::vector<ObjStats> stats;
+
+  static int16_t hor_res = 0;
+  static int16_t ver_res = 0;
+  static std::vector<uint32_t> total;  // Draws per pixel over the run
+  static std::vector<uint16_t> frame;  // Draws per pixel in the current refresh
+  static std::vector<uint16_t> peak;   // Most draws per pixel in one refresh
+
+  static bool frame_open = false;
+  static uint32_t frames = 0;
+  static uint64_t refreshed_px = 0;    // Pixels LVGL reported as refreshed
+  typedef void (*monitor_cb_t)(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+  static monitor_cb_t chained_monitor = NULL;
+
+  static std::string describe(lv_obj_t *obj) {
+    lv_obj_type_t type;
+    lv_obj_get_type(obj, &type);
+    lv_area_t a;
+    lv_obj_get_coords(obj, &a);
+    char text[64];
+    snprintf(text, sizeof text, "%s %d,%d %dx%d", type.type[0], a.x1, a.y1,
+             lv_area_get_width(&a), lv_area_get_height(&a));
+    return text;
+  }
+
+  // Deepest object of the active screen containing `area`
+  static lv_obj_t *owner(lv_obj_t *obj, const lv_area_t *area) {
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    if (!_lv_area_is_in(area, &coords, 0)) {
+      return NULL;
+    }
+    lv_obj_t *child = lv_obj_get_child(obj, NULL);
+    while (child) {
+      lv_obj_t *found = owner(child, area);
+      if (found) {
+        return found;
+      }
+      child = lv_obj_get_child(obj, child);
+    }
+    return obj;
+  }
+
+  static void open_frame() {
+    frame_open = true;
+    std::fill(frame.begin(), frame.end(), 0);
+
+    lv_disp_t *disp = lv_disp_get_default();
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+      if (disp->inv_area_joined[i]) {
+        continue;
+      }
+      const lv_area_t *area = &disp->inv_areas[i];
+      lv_obj_t *obj = owner(lv_scr_act(), area);
+      std::unordered_map<lv_obj_t *, Wrapped>::iterator it = wrapped.find(obj);
+      if (obj && it != wrapped.end()) {
+        ObjStats &s = stats[it->second.stats];
+        s.inv_areas++;
+        s.inv_px += lv_area_get_size(area);
+      }
+    }
+  }
+
+  static void close_frame(lv_disp_drv_t *drv, uint32_t time, uint32_t px) {
+    if (frame_open) {
+      frame_open = false;
+      frames++;
+      refreshed_px += px;
+      for (size_t i = 0; i < frame.size(); i++) {
+        peak[i] = std::max(peak[i], frame[i]);
+      }
+    }
+    if (chained_monitor) {
+      chained_monitor(drv, time, px);
+    }
+  }
+
+  static void record(ObjStats &s, const lv_area_t *clip) {
+    lv_area_t a = *clip;
+    a.x1 = std::max<lv_coord_t>(a.x1, 0);
+    a.y1 = std::max<lv_coord_t>(a.y1, 0);
+    a.x2 = std::min<lv_coord_t>(a.x2, hor_res - 1);
+    a.y2 = std::min<lv_coord_t>(a.y2, ver_res - 1);
+    if (a.x1 > a.x2 || a.y1 > a.y2) {
+      return;
+    }
+    for (lv_coord_t y = a.y1; y <= a.y2; y++) {
+      for (lv_coord_t x = a.x1; x <= a.x2; x++) {
+        size_t i = (size_t)y * hor_res + x;
+        total[i]++;
+        frame[i]++;
+      }
+    }
+    s.drawn_px += lv_area_get_size(&a);
+    if (s.last_frame != frames + 1) {
+      s.last_frame = frames + 1;
+      s.frames++;
+    }
+  }
+
+  static lv_design_res_t design(lv_obj_t *obj, const lv_area_t *clip, lv_design_mode_t mode) {
+    std::unordered_map<lv_obj_t *, Wrapped>::iterator it = wrapped.find(obj);
+    if (it == wrapped.end()) {
+      // Copied from a wrapped object before the next scan: original unknown
+      return mode == LV_DESIGN_COVER_CHK ? LV_DESIGN_RES_NOT_COVER : LV_DESIGN_RES_OK;
+    }
+    if (mode == LV_DESIGN_COVER_CHK) {
+      return it->second.design(obj, clip, mode);
+    }
+
+    if (!frame_open) {
+      open_frame();
+    }
+    ObjStats &s = stats[it->second.stats];
+    if (mode == LV_DESIGN_DRAW_MAIN) {
+      record(s, clip);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    lv_design_res_t res = it->second.design(obj, clip, mode);
+    s.draw_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return res;
+  }
+
+  static void wrap(lv_obj_t *obj) {
+    lv_design_cb_t cb = lv_obj_get_design_cb(obj);
+    if (cb && cb != design) {
+      ObjStats s = {describe(obj), 0, 0, 0, 0, 0, 0};
+      stats.push_back(s);
+      wrapped[obj] = {cb, stats.size() - 1};
+      lv_obj_set_design_cb(obj, design);
+    }
+    lv_obj_t *child = lv_obj_get_child(obj, NULL);
+    while (child) {
+      wrap(child);
+      child = lv_obj_get_child(obj, child);
+    }
+  }
+
+  void overdraw_enable() {
+    lv_disp_t *disp = lv_disp_get_default();
+    hor_res = lv_disp_get_hor_res(disp);
+    ver_res = lv_disp_get_ver_res(disp);
+    total.assign((size_t)hor_res * ver_res, 0);
+    frame.assign((size_t)hor_res * ver_res, 0);
+    peak.assign((size_t)hor_res * ver_res, 0);
+
+    chained_monitor = disp->driver.monitor_cb;
+    disp->driver.monitor_cb = close_frame;
+    enabled = true;
+    overdraw_scan();
+  }
+
+  void overdraw_scan() {
+    if (enabled) {
+      wrap(lv_scr_act());
+    }
+  }
+
+  // Cold to hot: blue, cyan, green, yellow, red
+  static void heat_color(double t, uint8_t *rgb) {
+    static const uint8_t ramp[5][3] = {{0, 0, 255}, {0, 255, 255}, {0, 255, 0}, {255, 255, 0}, {255, 0, 0}};
+    double pos = t * 4;
+    int i = std::min((int)pos, 3);
+    double f = pos - i;
+    for (int c = 0; c < 3; c++) {
+      rgb[c] = (uint8_t)(ramp[i][c] + (ramp[i + 1][c] - ramp[i][c]) * f);
+    }
+  }
+
+  bool overdraw_report(const char *png, const uint16_t *framebuffer, int16_t width, int16_t height) {
+    if (!enabled) {
+      return true;
+    }
+
+    // Draws over the run on a log scale, over a dimmed copy of the last frame
+    uint32_t most = *std::max_element(total.begin(), total.end());
+    std::vector<uint8_t> rgb((size_t)hor_res * ver_res * 3);
+    for (int16_t y = 0; y < ver_res; y++) {
+      for (int16_t x = 0; x < hor_res; x++) {
+        size_t i = (size_t)y * hor_res + x;
+        uint8_t *px = &rgb[i * 3];
+        uint8_t grey = 0;
+        if (x < width && y < height) {
+          uint16_t c = framebuffer[(size_t)y * width + x];
+          grey = (((c >> 11) & 0x1F) * 8 + ((c >> 5) & 0x3F) * 4 + (c & 0x1F) * 8) / 3;
+        }
+        if (total[i] == 0) {
+          px[0] = px[1] = px[2] = grey / 4;
+          continue;
+        }
+        heat_color(std::log(1.0 + total[i]) / std::log(1.0 + most), px);
+        for (int c = 0; c < 3; c++) {
+          px[c] = (px[c] * 3 + grey) / 4;
+        }
+      }
+    }
+    bool ok = lodepng_encode24_file(png, rgb.data(), hor_res, ver_res) == 0;
+
+    uint64_t drawn = 0;
+    uint16_t deepest = 0;
+    for (size_t i = 0; i < total.size(); i++) {
+      drawn += total[i];
+      deepest = std::max(deepest, peak[i]);
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < stats.size(); i++) {
+      if (stats[i].frames || stats[i].inv_areas) {
+        order.push_back(i);
+      }
+    }
+    std::sort(order.begin(), order.end(), [](size_t a, size_t b) { return stats[a].draw_us > stats[b].draw_us; });
+
+    double seconds = now_us() / 1e6;
+    fprintf(stderr, "overdraw          %u refreshes, %.2f draws per refreshed px, deepest %u\n", frames,
+            refreshed_px ? (double)drawn / refreshed_px : 0.0, deepest);
+    fprintf(stderr, "%-34s %8s %8s %12s %12s %10s\n", "object", "frames", "per s", "drawn px", "inv px", "draw us");
+    for (size_t i : order) {
+      const ObjStats &s = stats[i];
+      fprintf(stderr, "%-34s %8u %8.2f %12llu %12llu %10.0f\n", s.name.c_str(), s.frames,
+              seconds > 0 ? s.frames / seconds : 0.0, (unsigned long long)s.drawn_px,
+              (unsigned long long)s.inv_px, s.draw_us);
+    }
+    return ok;
+  }
+
+}
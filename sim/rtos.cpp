@@ -0,0 +1,209 @@
+/*
+ * FreeRTOS tasks for the host simulator
+ *
+ * Each task gets a thread, but only one thread runs at a time: the main loop
+ * hands over at a virtual millisecond boundary, when a task's wake time has
+ * come, and waits until the task blocks again. A task's own bus time runs on
+ * its core, not on the shared clock.
+ *
+ * Tasks are not started while the main loop is inside a single Wire call,
+ * which is all the Wire lock covers on the target. A task runs until it
+ * blocks, so here two tasks' I2C transfers never interleave and a missing
+ * I2CBus lock goes unnoticed; on the target a higher priority task can
+ * preempt between requestFrom() and the reads that follow.
+ */
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "Arduino.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+namespace sim {
+
+  typedef struct Task {
+    TaskFunction_t fn;
+    void *arg;
+    const char *name;
+    uint64_t wake_us;    // On the shared clock
+    uint64_t elapsed_us; // Own time since it was started this time
+    bool running;
+    uint32_t notified;   // Notification count
+    bool waiting;        // Blocked in ulTaskNotifyTake()
+  } Task;
+
+  // Stands for the Arduino loop task, which runs on the main thread
+  static Task main_loop = {NULL, NULL, "loop", 0, 0, true, 0, false};
+
+  // Never destroyed: task threads are still parked in them at exit
+  static std::mutex &lock = *new std::mutex;
+  static std::condition_variable &handover = *new std::condition_variable;
+  static std::vector<Task *> tasks;
+  static thread_local Task *current = NULL;
+  static uint64_t busy_us = 0; // Task time over the run, all on core 0 on the target
+
+  bool in_task() {
+    return current != NULL;
+  }
+
+  void task_advance_us(uint64_t us) {
+    current->elapsed_us += us;
+  }
+
+  uint64_t task_elapsed_us() {
+    return current ? current->elapsed_us : 0;
+  }
+
+  // Give the CPU back to the main loop until the shared clock reaches `wake_us`
+  static void block_until(uint64_t wake_us) {
+    Task *task = current;
+    std::unique_lock<std::mutex> guard(lock);
+    task->wake_us = wake_us;
+    task->running = false;
+    handover.notify_all();
+    handover.wait(guard, [task] { return task->running; });
+  }
+
+  static void task_main(Task *task) {
+    current = task;
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      handover.wait(guard, [task] { return task->running; });
+    }
+    task->fn(task->arg);
+    // A returning task is deleted: it never wakes again
+    block_until(UINT64_MAX);
+  }
+
+  void run_tasks() {
+    for (Task *task : tasks) {
+      if (task->wake_us > now_us()) {
+        continue;
+      }
+      std::unique_lock<std::mutex> guard(lock);
+      task->elapsed_us = 0;
+      task->running = true;
+      handover.notify_all();
+      handover.wait(guard, [task] { return !task->running; });
+      busy_us += task->elapsed_us;
+    }
+  }
+
+  uint64_t tasks_busy_us() {
+    return busy_us;
+  }
+
+}
+
+// Main thread: advance the clock a tick at a time, tasks may notify on the way
+static uint32_t take_in_loop(BaseType_t clear, TickType_t ticks) {
+  sim::account_cpu();
+  uint64_t start = sim::now_us();
+  uint64_t deadline = ticks == portMAX_DELAY ? UINT64_MAX : start + (uint64_t)ticks * 1000;
+  while (sim::main_loop.notified == 0 && sim::now_us() < deadline) {
+    uint64_t now = sim::now_us();
+    uint64_t step = std::min<uint64_t>((now / 1000 + 1) * 1000, deadline) - now;
+    sim::advance_us(step);
+  }
+  if (sim::now_us() > start) {
+    sim::LoopStats &stats = sim::loop_stats();
+    stats.wakeups++;
+    stats.idle_us += sim::now_us() - start;
+  }
+  uint32_t count = sim::main_loop.notified;
+  sim::main_loop.notified = clear ? 0 : (count ? count - 1 : 0);
+  return count;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *handle, BaseType_t core) {
+  (void)stack;
+  (void)prio;
+  (void)core;
+  sim::Task *task = new sim::Task{fn, arg, name, sim::now_us(), 0, false, 0, false};
+  sim::tasks.push_back(task);
+  std::thread(sim::task_main, task).detach();
+  if (handle) {
+    *handle = task;
+  }
+  return pdPASS;
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(sim::now_us() / 1000);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  sim::block_until((sim::now_us() / 1000 + (ticks ? ticks : 1)) * 1000);
+}
+
+// Wakes on the tick grid, late wakeups don't shift later periods
+void vTaskDelayUntil(TickType_t *previous, TickType_t increment) {
+  *previous += increment;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(*previous - now) <= 0) {
+    sim::block_until(sim::now_us());
+    return;
+  }
+  sim::block_until((uint64_t)*previous * 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return sim::current ? sim::current : &sim::main_loop;
+}
+
+// A waiting task runs again at the next tick boundary
+void xTaskNotifyGive(TaskHandle_t handle) {
+  sim::Task *task = (sim::Task *)handle;
+  task->notified++;
+  if (task->waiting) {
+    task->wake_us = 0;
+  }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+  if (!sim::current) {
+    return take_in_loop(clear, ticks);
+  }
+  sim::Task *task = sim::current;
+  if (task->notified == 0 && ticks > 0) {
+    task->waiting = true;
+    sim::block_until(ticks == portMAX_DELAY ? UINT64_MAX : (sim::now_us() / 1000 + ticks) * 1000);
+    task->waiting = false;
+  }
+  uint32_t count = task->notified;
+  task->notified = clear ? 0 : (count ? count - 1 : 0);
+  return count;
+}
+
+// Mutexes wait on the tick grid; the main loop keeps running tasks meanwhile
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new bool(false);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+  bool *held = (bool *)mutex;
+  uint64_t deadline = ticks == portMAX_DELAY ? UINT64_MAX : sim::now_us() + (uint64_t)ticks * 1000;
+  while (*held) {
+    uint64_t now = sim::now_us();
+    if (now >= deadline) {
+      return pdFALSE;
+    }
+    uint64_t next = (now / 1000 + 1) * 1000;
+    if (sim::current) {
+      sim::block_until(next);
+    } else {
+      sim::advance_us(next - now);
+    }
+  }
+  *held = true;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  *(bool *)mutex = false;
+  return pdTRUE;
+}
@@ -0,0 +1,667 @@
+/*
+ * Host simulator: virtual clock, scripted buses and the main() that drives
+ * the firmware's setup()/loop()
+ */
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TFT_eSPI.h"
+#include "lvgl.h"
+
+// lodepng is built as C inside lv_lib_png
+#define LODEPNG_NO_COMPILE_CPP
+extern "C" {
+  #include "lodepng.h"
+}
+
+void setup();
+void loop();
+
+extern TFT_eSPI lcd;
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+namespace sim {
+
+  double cpuScale = 0;
+  uint32_t i2cFrequency = 100000;
+  uint32_t i2cBusy = 0;
+
+  static uint64_t clock_us = 0;
+  static tick_hook_t tick_hook = NULL;
+  static std::chrono::steady_clock::time_point cpu_mark = std::chrono::steady_clock::now();
+
+  static bool quiet = false;
+  static std::string serial_in;
+  static size_t serial_pos = 0;
+
+  static void touch_scan(uint64_t ms);
+
+  static I2CDevice *i2c_devices[128];
+  static I2CStats i2c_counters = {0};
+  static SpiStats spi_counters = {0};
+  static UartStats uart_counters = {0};
+  static LoopStats loop_counters = {0};
+  static double uart_byte_us = 10 * 1e6 / 115200;
+  static double uart_idle_us = 0; // When the FIFO runs empty
+
+  uint64_t now_us() {
+    return clock_us + task_elapsed_us();
+  }
+
+  void advance_us(uint64_t us) {
+    if (in_task()) {
+      task_advance_us(us);
+      return;
+    }
+    uint64_t end = clock_us + us;
+    // FreeRTOS tick hook fires on every millisecond boundary crossed
+    while ((clock_us / 1000) < (end / 1000)) {
+      clock_us = (clock_us / 1000 + 1) * 1000;
+      touch_scan(clock_us / 1000);
+      if (tick_hook) {
+        tick_hook();
+      }
+      if (!i2cBusy) {
+        run_tasks();
+        cpu_mark = std::chrono::steady_clock::now();
+      }
+    }
+    clock_us = end;
+  }
+
+  void account_cpu() {
+    if (in_task()) {
+      return; // Host time of tasks is not modelled
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (cpuScale > 0) {
+      double ns = std::chrono::duration<double, std::nano>(now - cpu_mark).count();
+      advance_us((uint64_t)(ns * cpuScale / 1000));
+    }
+    cpu_mark = now;
+  }
+
+  void set_tick_hook(tick_hook_t hook) {
+    tick_hook = hook;
+  }
+
+  void i2c_attach(uint8_t address, I2CDevice *device) {
+    i2c_devices[address & 0x7F] = device;
+  }
+
+  I2CDevice *i2c_device(uint8_t address) {
+    return i2c_devices[address & 0x7F];
+  }
+
+  I2CStats &i2c_stats() {
+    return i2c_counters;
+  }
+
+  SpiStats &spi_stats() {
+    return spi_counters;
+  }
+
+  UartStats &uart_stats() {
+    return uart_counters;
+  }
+
+  LoopStats &loop_stats() {
+    return loop_counters;
+  }
+
+  // Returns once the last byte is in the FIFO, as the ESP32 driver does
+  static void uart_transmit(size_t len) {
+    static const size_t fifo = 128;
+    double now = now_us();
+    uart_idle_us = std::max(uart_idle_us, now) + len * uart_byte_us;
+    double queued_until = uart_idle_us - fifo * uart_byte_us;
+    uart_counters.bytes += len;
+    if (queued_until > now) {
+      uint64_t wait = (uint64_t)(queued_until - now + 0.5);
+      uart_counters.blocked++;
+      uart_counters.blocked_us += wait;
+      advance_us(wait);
+    }
+  }
+
+  // Start, address byte and one ACK bit per byte, then stop
+  static void i2c_transfer(size_t bytes) {
+    i2c_counters.bytes += bytes + 1;
+    advance_us(((bytes + 1) * 9 + 2) * 1000000ULL / i2cFrequency);
+  }
+
+  /*
+   * FT6236 register file. Touch registers are refreshed from the script each
+   * time the register pointer is written, like the controller latching a scan.
+   */
+  class TouchPanel : public I2CDevice {
+
+    public:
+      typedef struct Event {
+        uint64_t at_ms;
+        bool down;
+        uint16_t x;
+        uint16_t y;
+      } Event;
+
+      std::vector<Event> events;
+
+      /*
+       * INT line in trigger mode: one low pulse per report while a finger is
+       * down, and one for the release, at the 100 Hz report rate.
+       */
+      void scan(uint64_t ms) {
+        bool down = false;
+        bool changed = false;
+        for (const Event &e : events) {
+          if (e.at_ms > ms) {
+            break;
+          }
+          down = e.down;
+          changed |= e.at_ms > m_scanMs;
+        }
+        bool report = down && (ms / TOUCH_REPORT_MS) != (m_scanMs / TOUCH_REPORT_MS);
+        m_scanMs = ms;
+        if (changed || report) {
+#ifdef PIN_TOUCH_INT
+          gpio_edge(PIN_TOUCH_INT, FALLING);
+#endif
+        }
+      }
+
+      TouchPanel() {
+        memset(m_regs, 0, sizeof m_regs);
+        m_regs[0xA3] = 0x36; // FT6236
+        m_regs[0xA6] = 0x10;
+        m_regs[0xA8] = 0x11; // FocalTech
+        m_regs[0x80] = 0x80;
+        m_regs[0x88] = 0x0E;
+      }
+
+      void onWrite(const uint8_t *data, size_t len) override {
+        if (len == 0) {
+          return;
+        }
+        m_ptr = data[0];
+        for (size_t i = 1; i < len; i++) {
+          m_regs[(uint8_t)(m_ptr + i - 1)] = data[i];
+        }
+        latch();
+      }
+
+      size_t onRead(uint8_t *data, size_t len) override {
+        for (size_t i = 0; i < len; i++) {
+          data[i] = m_regs[(uint8_t)(m_ptr + i)];
+        }
+        return len;
+      }
+
+    private:
+      uint8_t m_regs[256];
+      uint8_t m_ptr = 0;
+      bool m_wasDown = false;
+      uint64_t m_scanMs = 0;
+
+      static const uint64_t TOUCH_REPORT_MS = 10;
+
+      void latch() {
+        const Event *current = NULL;
+        uint64_t ms = now_us() / 1000;
+        for (const Event &e : events) {
+          if (e.at_ms > ms) {
+            break;
+          }
+          current = &e;
+        }
+
+        bool down = current && current->down;
+        if (!down) {
+          m_regs[0x02] = 0;
+          m_regs[0x03] = 0x40 | 0x0F; // Lift up, no point
+          m_regs[0x04] = 0xFF;
+          m_regs[0x05] = 0xFF;
+          m_regs[0x06] = 0xFF;
+          m_wasDown = false;
+          return;
+        }
+
+        // The panel is mounted rotated; the driver maps P1_X to screen Y and flips it
+        uint16_t rawX = TFT_WIDTH - current->y;
+        uint16_t rawY = current->x;
+        uint8_t event = m_wasDown ? 0x80 : 0x00; // Contact : Press down
+
+        m_regs[0x02] = 1;
+        m_regs[0x03] = event | ((rawX >> 8) & 0x0F);
+        m_regs[0x04] = rawX & 0xFF;
+        m_regs[0x05] = (0 << 4) | ((rawY >> 8) & 0x0F); // Touch ID 0
+        m_regs[0x06] = rawY & 0xFF;
+        m_wasDown = true;
+      }
+  };
+
+  static TouchPanel touch_panel;
+
+  static void touch_scan(uint64_t ms) {
+    touch_panel.scan(ms);
+  }
+
+  static void touch_add(const TouchPanel::Event &e) {
+    std::vector<TouchPanel::Event> &events = touch_panel.events;
+    events.push_back(e);
+    std::stable_sort(events.begin(), events.end(), [](const TouchPanel::Event &a, const TouchPanel::Event &b) {
+      return a.at_ms < b.at_ms;
+    });
+  }
+
+  void touch_down(uint64_t at_ms, uint16_t x, uint16_t y) {
+    touch_add({at_ms, true, x, y});
+  }
+
+  void touch_up(uint64_t at_ms) {
+    touch_add({at_ms, false, 0, 0});
+  }
+
+  // Presses in the script: down events not preceded by another down
+  uint32_t touch_taps() {
+    uint32_t taps = 0;
+    bool down = false;
+    for (const TouchPanel::Event &e : touch_panel.events) {
+      taps += e.down && !down;
+      down = e.down;
+    }
+    return taps;
+  }
+
+  // One event per line: "<ms> down <x> <y>" or "<ms> up", '#' starts a comment
+  bool touch_load(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+      return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof line, f)) {
+      unsigned long long ms;
+      char what[8];
+      unsigned x, y;
+      if (line[0] == '#' || sscanf(line, "%llu %7s", &ms, what) != 2) {
+        continue;
+      }
+      if (strcmp(what, "down") == 0 && sscanf(line, "%*u %*s %u %u", &x, &y) == 2) {
+        touch_down(ms, x, y);
+      } else if (strcmp(what, "up") == 0) {
+        touch_up(ms);
+      }
+    }
+    fclose(f);
+    return true;
+  }
+
+}
+
+// Arduino core
+
+void HardwareSerial::begin(unsigned long baud) {
+  sim::uart_byte_us = 10 * 1e6 / baud;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!sim::quiet) {
+    fputc(c, stdout);
+  }
+  sim::uart_transmit(1);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t len) {
+  if (!sim::quiet) {
+    fwrite(data, 1, len, stdout);
+  }
+  sim::uart_transmit(len);
+  return len;
+}
+
+int HardwareSerial::available() {
+  return sim::serial_in.size() - sim::serial_pos;
+}
+
+int HardwareSerial::read() {
+  if (sim::serial_pos >= sim::serial_in.size()) {
+    return -1;
+  }
+  return (uint8_t)sim::serial_in[sim::serial_pos++];
+}
+
+unsigned long millis() {
+  sim::account_cpu();
+  return sim::now_us() / 1000;
+}
+
+unsigned long micros() {
+  sim::account_cpu();
+  return sim::now_us();
+}
+
+void delay(uint32_t ms) {
+  sim::account_cpu();
+  if (!sim::in_task() && ms > 0) {
+    sim::loop_counters.wakeups++;
+    sim::loop_counters.idle_us += (uint64_t)ms * 1000;
+  }
+  sim::advance_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  sim::account_cpu();
+  sim::advance_us(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+static uint8_t pin_levels[64];
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  pin_levels[pin & 63] = val;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin_levels[pin & 63];
+}
+
+typedef struct Interrupt {
+  void (*handler)(void *);
+  void *arg;
+  int mode;
+} Interrupt;
+
+static Interrupt interrupts[64];
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode) {
+  interrupts[pin & 63] = {handler, arg, mode};
+}
+
+void detachInterrupt(uint8_t pin) {
+  interrupts[pin & 63] = {NULL, NULL, 0};
+}
+
+void sim::gpio_edge(uint8_t pin, int mode) {
+  const Interrupt &irq = interrupts[pin & 63];
+  if (irq.handler && (irq.mode & mode)) {
+    irq.handler(irq.arg);
+  }
+}
+
+static uint32_t ledc_duty[16];
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) {
+  (void)channel;
+  (void)resolution_bits;
+  return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+  (void)pin;
+  (void)channel;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+  ledc_duty[channel & 15] = duty;
+}
+
+// Wire
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  (void)sda;
+  (void)scl;
+  if (frequency) {
+    sim::i2cFrequency = frequency;
+  }
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  sim::i2cFrequency = frequency;
+  return true;
+}
+
+void TwoWire::beginTransmission(int address) {
+  if (!m_locked) {
+    m_locked = true;
+    sim::i2cBusy++;
+  }
+  m_txAddress = address;
+  m_txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (m_txLength >= sizeof m_txBuffer) {
+    return 0;
+  }
+  m_txBuffer[m_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  sim::account_cpu();
+  sim::i2c_stats().writes++;
+  sim::i2c_stats().transactions[m_txAddress & 0x7F]++;
+  sim::I2CDevice *device = sim::i2c_device(m_txAddress);
+  uint8_t result = 2; // Address NACK
+  if (device) {
+    sim::i2c_transfer(m_txLength);
+    device->onWrite(m_txBuffer, m_txLength);
+    result = 0;
+  } else {
+    sim::i2c_transfer(0);
+  }
+  if (m_locked) {
+    m_locked = false;
+    sim::i2cBusy--;
+  }
+  return result;
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity) {
+  sim::i2cBusy++;
+  sim::account_cpu();
+  sim::i2c_stats().reads++;
+  sim::i2c_stats().transactions[address & 0x7F]++;
+  m_rxIndex = 0;
+  m_rxLength = 0;
+  sim::I2CDevice *device = sim::i2c_device(address);
+  if (device) {
+    size_t len = std::min((size_t)quantity, sizeof m_rxBuffer);
+    m_rxLength = device->onRead(m_rxBuffer, len);
+  }
+  sim::i2c_transfer(m_rxLength);
+  sim::i2cBusy--;
+  return m_rxLength;
+}
+
+int TwoWire::available() {
+  return m_rxLength - m_rxIndex;
+}
+
+int TwoWire::read() {
+  if (m_rxIndex >= m_rxLength) {
+    return -1;
+  }
+  return m_rxBuffer[m_rxIndex++];
+}
+
+size_t TwoWire::readBytes(uint8_t *buffer, size_t len) {
+  size_t n = 0;
+  while (n < len && m_rxIndex < m_rxLength) {
+    buffer[n++] = m_rxBuffer[m_rxIndex++];
+  }
+  return n;
+}
+
+// Framebuffer dump, PNG or binary PPM depending on the extension
+
+bool TFT_eSPI::dump(const char *path) const {
+  std::vector<uint8_t> rgb((size_t)m_width * m_height * 3);
+  for (size_t i = 0; i < (size_t)m_width * m_height; i++) {
+    uint16_t c = m_fb[i];
+    rgb[i * 3 + 0] = ((c >> 11) & 0x1F) * 255 / 31;
+    rgb[i * 3 + 1] = ((c >> 5) & 0x3F) * 255 / 63;
+    rgb[i * 3 + 2] = (c & 0x1F) * 255 / 31;
+  }
+
+  size_t n = strlen(path);
+  if (n > 4 && strcmp(path + n - 4, ".png") == 0) {
+    return lodepng_encode24_file(path, rgb.data(), m_width, m_height) == 0;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", m_width, m_height);
+  fwrite(rgb.data(), 1, rgb.size(), f);
+  fclose(f);
+  return true;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --ms <n>           virtual time to run, default 10000\n"
+          "  --touch <file>     touch script, lines of \"<ms> down <x> <y>\" or \"<ms> up\"\n"
+          "  --serial <text>    bytes fed to the serial port\n"
+          "  --serial-end <text> bytes fed after --ms, then the run goes on for 500 ms, unmuted\n"
+          "  --serial-every <ms> <text> bytes fed every <ms> of virtual time, e.g. periodic reports\n"
+          "  --dump <file>      write the final frame as .png or .ppm\n"
+          "  --overdraw <file>  write a per-pixel draw count heatmap .png, table on stderr\n"
+          "  --cpu-scale <f>    charge host CPU time x f to the virtual clock\n"
+          "  --quiet            drop Serial output\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  uint64_t run_ms = 10000;
+  const char *dump_path = NULL;
+  const char *overdraw_path = NULL;
+  std::string serial_end;
+  std::string serial_every;
+  uint64_t every_ms = 0;
+
+  for (int i = 1; i < argc; i++) {
+    bool has_arg = i + 1 < argc;
+    if (strcmp(argv[i], "--ms") == 0 && has_arg) {
+      run_ms = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--touch") == 0 && has_arg) {
+      if (!sim::touch_load(argv[++i])) {
+        fprintf(stderr, "cannot read touch script %s\n", argv[i]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--serial") == 0 && has_arg) {
+      sim::serial_in += argv[++i];
+    } else if (strcmp(argv[i], "--serial-end") == 0 && has_arg) {
+      serial_end += argv[++i];
+    } else if (strcmp(argv[i], "--serial-every") == 0 && i + 2 < argc) {
+      every_ms = strtoull(argv[++i], NULL, 10);
+      serial_every = argv[++i];
+    } else if (strcmp(argv[i], "--dump") == 0 && has_arg) {
+      dump_path = argv[++i];
+    } else if (strcmp(argv[i], "--overdraw") == 0 && has_arg) {
+      overdraw_path = argv[++i];
+    } else if (strcmp(argv[i], "--cpu-scale") == 0 && has_arg) {
+      sim::cpuScale = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      sim::quiet = true;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  sim::i2c_attach(0x38, &sim::touch_panel);
+
+  sim::account_cpu();
+  setup();
+  if (overdraw_path) {
+    sim::overdraw_enable();
+  }
+  uint64_t next_every = every_ms;
+  while (millis() < run_ms) {
+    // Screens built lazily get wrapped before their first refresh
+    sim::overdraw_scan();
+    if (every_ms && millis() >= next_every) {
+      sim::serial_in += serial_every;
+      next_every += every_ms;
+    }
+    sim::loop_counters.calls++;
+    loop();
+  }
+
+  // End of run reports from the firmware, e.g. "prof"
+  if (!serial_end.empty()) {
+    sim::quiet = false;
+    sim::serial_in += serial_end;
+    while (millis() < run_ms + 500) {
+      loop();
+    }
+  }
+
+  if (dump_path && !lcd.dump(dump_path)) {
+    fprintf(stderr, "cannot write %s\n", dump_path);
+    return 1;
+  }
+
+  if (overdraw_path && !sim::overdraw_report(overdraw_path, lcd.framebuffer(), lcd.width(), lcd.height())) {
+    fprintf(stderr, "cannot write %s\n", overdraw_path);
+    return 1;
+  }
+
+  const sim::SpiStats &spi = sim::spi_stats();
+  const sim::I2CStats &i2c = sim::i2c_stats();
+  fprintf(stderr, "virtual time      %llu ms\n", (unsigned long long)(sim::now_us() / 1000));
+  fprintf(stderr, "spi transfers     %u (%u windows)\n", spi.transfers, spi.windows);
+  fprintf(stderr, "spi bytes         %llu\n", (unsigned long long)spi.bytes);
+  fprintf(stderr, "spi busy          %llu us\n", (unsigned long long)spi.busy_us);
+  fprintf(stderr, "cpu blocked       %llu us\n", (unsigned long long)spi.wait_us);
+  fprintf(stderr, "spi/cpu overlap   %llu us\n", (unsigned long long)(spi.busy_us - spi.wait_us));
+  if (spi.first_full_us) {
+    fprintf(stderr, "panel first full  %llu ms\n", (unsigned long long)(spi.first_full_us / 1000));
+  } else {
+    fprintf(stderr, "panel first full  never\n");
+  }
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  fprintf(stderr, "lvgl heap         %u bytes used, %u peak\n", (unsigned)(mon.total_size - mon.free_size),
+          (unsigned)mon.max_used);
+  const sim::UartStats &uart = sim::uart_stats();
+  fprintf(stderr, "uart tx           %llu bytes, %u writes blocked for %llu us\n", (unsigned long long)uart.bytes,
+          uart.blocked, (unsigned long long)uart.blocked_us);
+  const sim::LoopStats &idle = sim::loop_stats();
+  double seconds = sim::now_us() / 1e6;
+  fprintf(stderr, "main loop         %.1f wakeups/s, %.1f%% busy (core 1)\n", seconds > 0 ? idle.wakeups / seconds : 0.0,
+          seconds > 0 ? 100.0 - idle.idle_us / (seconds * 1e4) : 0.0);
+  fprintf(stderr, "loop() calls      %.1f/s, lvgl idle %u%%\n", seconds > 0 ? idle.calls / seconds : 0.0,
+          (unsigned)lv_task_get_idle());
+  fprintf(stderr, "tasks             %.1f%% busy (core 0)\n", seconds > 0 ? sim::tasks_busy_us() / (seconds * 1e4) : 0.0);
+  fprintf(stderr, "i2c transactions  %u writes, %u reads, %llu bytes\n", i2c.writes, i2c.reads, (unsigned long long)i2c.bytes);
+  double minutes = sim::now_us() / 60e6;
+  uint32_t touch = i2c.transactions[0x38];
+  fprintf(stderr, "i2c touch (0x38)  %u transactions, %.0f/min\n", touch, minutes > 0 ? touch / minutes : 0.0);
+  fprintf(stderr, "touch taps        %u scripted\n", sim::touch_taps());
+  return 0;
+}
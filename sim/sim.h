@@ -0,0 +1,98 @@
+/*
+ * Host simulator runtime shared by the Arduino, Wire and TFT_eSPI stand-ins
+ */
+#ifndef _SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+  #define _SIM_H_ 1
+
+  namespace sim {
+
+    // Virtual clock, advanced by delay(), blocking bus transfers and waits.
+    // Host CPU time spent in firmware code is added scaled by cpuScale
+    // (0 keeps runs fully deterministic).
+    uint64_t now_us();
+    void advance_us(uint64_t us);
+    void account_cpu();
+    extern double cpuScale;
+
+    // FreeRTOS tasks, see rtos.cpp. Inside a task the clock reads the
+    // shared time plus the task's own time since it was started.
+    bool in_task();
+    void task_advance_us(uint64_t us);
+    uint64_t task_elapsed_us();
+    void run_tasks();
+    uint64_t tasks_busy_us();   // Bus time of all tasks, their CPU time is not modelled
+
+    typedef void (*tick_hook_t)(void);
+    void set_tick_hook(tick_hook_t hook);
+
+    // Scripted I2C bus
+    class I2CDevice {
+      public:
+        virtual ~I2CDevice() {}
+        virtual void onWrite(const uint8_t *data, size_t len) = 0;
+        virtual size_t onRead(uint8_t *data, size_t len) = 0;
+    };
+
+    typedef struct I2CStats {
+      uint32_t writes;  // Write transactions, acknowledged or not
+      uint32_t reads;   // Read transactions
+      uint64_t bytes;   // Bytes moved, address bytes included
+      uint32_t transactions[128]; // Writes and reads per device address
+    } I2CStats;
+
+    void i2c_attach(uint8_t address, I2CDevice *device);
+    I2CDevice *i2c_device(uint8_t address);
+    I2CStats &i2c_stats();
+    extern uint32_t i2cBusy; // Main loop inside a Wire call, tasks wait
+    extern uint32_t i2cFrequency;
+
+    // Touches injected into the simulated FT62xx controller, in screen coordinates
+    void touch_down(uint64_t at_ms, uint16_t x, uint16_t y);
+    void touch_up(uint64_t at_ms);
+    bool touch_load(const char *path);
+    uint32_t touch_taps();
+
+    // Drive a GPIO edge into the handler attached to `pin`, if any
+    void gpio_edge(uint8_t pin, int mode);
+
+    typedef struct SpiStats {
+      uint32_t transfers;  // Pixel pushes, blocking and DMA
+      uint32_t windows;    // Address windows set
+      uint64_t bytes;      // Bytes on the wire, commands included
+      uint64_t busy_us;    // Time the bus was transmitting
+      uint64_t wait_us;    // Time the CPU was blocked on the bus
+      uint64_t first_full_us; // Every pixel of the panel had been sent once
+    } SpiStats;
+
+    SpiStats &spi_stats();
+
+    // UART TX behind a 128 byte FIFO at the Serial.begin() baud rate
+    typedef struct UartStats {
+      uint64_t bytes;
+      uint32_t blocked;    // Writes that waited for FIFO space
+      uint64_t blocked_us; // Time writers were blocked
+    } UartStats;
+
+    UartStats &uart_stats();
+
+    // Main loop blocked in delay() or a notification wait, as the target would idle
+    typedef struct LoopStats {
+      uint32_t calls;    // loop() calls
+      uint32_t wakeups;  // Waits that blocked and returned
+      uint64_t idle_us;
+    } LoopStats;
+
+    LoopStats &loop_stats();
+
+    // Overdraw analyzer, see overdraw.cpp. Scan after new objects were created.
+    void overdraw_enable();
+    void overdraw_scan();
+    bool overdraw_report(const char *png, const uint16_t *framebuffer, int16_t width, int16_t height);
+
+  }
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * Static dashboard chrome pre-rendered once into opaque canvases
+ *
+ * A cached caption is its text already blended onto the panel background. It
+ * redraws as a plain opaque image copy, with no glyph rendering, and LVGL's
+ * cover check starts any refresh inside it at the canvas instead of at the
+ * screen background. Buffers come from the system heap, not the LVGL pool.
+ */
+#ifndef _ChromeCache_H_
+
+#include <stdlib.h>
+#include "lvgl.h"
+
+  #define _ChromeCache_H_ 1
+
+  #ifndef CHROME_CACHE
+    #define CHROME_CACHE 0
+  #endif
+
+  // Replace a static label with a pre-rendered copy. Returns the object now
+  // on screen: the canvas, or the label itself if there was no memory for it.
+  static inline lv_obj_t *chrome_cache_label(lv_obj_t *label) {
+    lv_obj_t *parent = lv_obj_get_parent(label);
+    lv_coord_t w = lv_obj_get_width(label);
+    lv_coord_t h = lv_obj_get_height(label);
+
+    lv_color_t *buf = (lv_color_t *)malloc(LV_CANVAS_BUF_SIZE_TRUE_COLOR(w, h));
+    if (buf == NULL) {
+      return label;
+    }
+
+    lv_obj_t *canvas = lv_canvas_create(parent, NULL);
+    lv_canvas_set_buffer(canvas, buf, w, h, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, lv_obj_get_style_bg_color(parent, LV_OBJ_PART_MAIN), LV_OPA_COVER);
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    lv_obj_init_draw_label_dsc(label, LV_LABEL_PART_MAIN, &dsc);
+    lv_canvas_draw_text(canvas, 0, 0, w, &dsc, lv_label_get_text(label), lv_label_get_align(label));
+
+    lv_obj_set_pos(canvas, lv_obj_get_x(label), lv_obj_get_y(label));
+    lv_obj_del(label);
+    return canvas;
+  }
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Per-core CPU load from the FreeRTOS idle hooks
+ *
+ * The hooks ask to be called again straight away, so back-to-back calls
+ * are idle time and any longer gap went to other tasks or interrupts. That
+ * keeps the idle task spinning instead of waiting for interrupts, so this
+ * is only built into profiler builds on the target. The host simulator
+ * prints its own per-core figures on exit.
+ */
+#ifndef _CoreLoad_H_
+
+#include <Arduino.h>
+#include "esp_freertos_hooks.h"
+
+  #define _CoreLoad_H_ 1
+
+  #define CORE_COUNT 2
+  #define CORE_IDLE_GAP_US 20 // A longer gap between idle hook calls was busy
+
+  class CoreLoad {
+
+    public:
+      bool begin() {
+        m_mark = micros();
+        return esp_register_freertos_idle_hook_for_cpu(idle0, 0) == ESP_OK &&
+               esp_register_freertos_idle_hook_for_cpu(idle1, 1) == ESP_OK;
+      }
+
+      // Busy percentage of each core since the previous call
+      void sample(uint8_t busy[CORE_COUNT]) {
+        uint32_t now = micros();
+        uint32_t elapsed = now - m_mark;
+        m_mark = now;
+        uint32_t mhz = ESP.getCpuFreqMHz();
+        for (uint8_t core = 0; core < CORE_COUNT; core++) {
+          uint32_t idle = m_idleCycles[core];
+          uint32_t idleUs = (idle - m_idleMark[core]) / mhz;
+          m_idleMark[core] = idle;
+          busy[core] = elapsed == 0 || idleUs >= elapsed ? 0 : 100 - (uint64_t)idleUs * 100 / elapsed;
+        }
+      }
+
+    private:
+      volatile uint32_t m_idleCycles[CORE_COUNT] = {0};
+      uint32_t m_lastCall[CORE_COUNT] = {0};
+      uint32_t m_idleMark[CORE_COUNT] = {0};
+      uint32_t m_mark = 0;
+
+      static bool idle0();
+      static bool idle1();
+      bool idle(uint8_t core);
+  };
+
+  extern CoreLoad coreLoad;
+
+  // Cycle counters are per core, each hook only reads its own
+  inline bool CoreLoad::idle(uint8_t core) {
+    uint32_t now = ESP.getCycleCount();
+    uint32_t gap = now - m_lastCall[core];
+    m_lastCall[core] = now;
+    if (gap < CORE_IDLE_GAP_US * ESP.getCpuFreqMHz()) {
+      m_idleCycles[core] += gap;
+    }
+    return false;
+  }
+
+  inline bool CoreLoad::idle0() {
+    return coreLoad.idle(0);
+  }
+
+  inline bool CoreLoad::idle1() {
+    return coreLoad.idle(1);
+  }
+
+#endif
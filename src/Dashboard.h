@@ -0,0 +1,207 @@
+/*
+ * Main screen captions and values drawn by one object
+ *
+ * Every caption/value pair is a cell: a few bytes in a DashboardCell instead
+ * of two label objects with their own style lists and text allocations. The
+ * dashboard object draws all cells from its design callback, and a changed
+ * value invalidates only the area of its own text.
+ */
+#ifndef _Dashboard_H_
+
+#include <string.h>
+#include "lvgl.h"
+#include "Fixed.h"
+
+  #define _Dashboard_H_ 1
+
+  #ifndef DASHBOARD
+    #define DASHBOARD 1
+  #endif
+
+  // The caption cache works on the label main screen only
+  #if DASHBOARD && defined(CHROME_CACHE) && CHROME_CACHE
+    #error "CHROME_CACHE needs DASHBOARD=0"
+  #endif
+
+  #define DASHBOARD_MAX_CELLS 8
+
+  class Dashboard;
+
+  class DashboardCell {
+
+    public:
+      // `x`, `y` and `valueX` are relative to `body`, as label positions were
+      void bind(Dashboard &dash, lv_obj_t *body, lv_coord_t x, lv_coord_t y, const char *caption,
+                lv_coord_t valueX, uint8_t decimals, const char *suffix);
+
+      // Same contract as ValueLabel: true if the cell was invalidated
+      bool set(milli_t value) {
+        int32_t shown = milli_round(value, m_decimals);
+        if (m_valid && m_text == m_buf && shown == m_shown) {
+          return false;
+        }
+        m_shown = shown;
+        milli_format(m_buf, sizeof m_buf, value, m_decimals, m_suffix);
+        show(m_buf);
+        return true;
+      }
+
+      bool setText(const char *text) {
+        if (m_valid && text == m_text) {
+          return false;
+        }
+        show(text);
+        return true;
+      }
+
+      void captionArea(lv_area_t *area) const;
+      void valueArea(lv_area_t *area) const;
+      void draw(const lv_area_t *clip, const lv_draw_label_dsc_t *dsc) const;
+
+    private:
+      Dashboard *m_dash = NULL;
+      const char *m_caption = "";
+      const char *m_text = "";  // m_buf or a static string
+      const char *m_suffix = "";
+      lv_coord_t m_x = 0;       // Relative to the dashboard object
+      lv_coord_t m_y = 0;
+      lv_coord_t m_valueX = 0;
+      lv_coord_t m_captionWidth = 0;
+      lv_coord_t m_valueWidth = 0;
+      int32_t m_shown = 0;
+      uint8_t m_decimals = 0;
+      bool m_valid = false;
+      char m_buf[16];
+
+      void show(const char *text);
+  };
+
+  class Dashboard {
+
+    public:
+      // Transparent and not clickable, so touches and cover checks go to the objects below
+      void create(lv_obj_t *parent, lv_style_t *text_style) {
+        m_obj = lv_obj_create(parent, NULL);
+        lv_obj_set_size(m_obj, lv_obj_get_width(parent), lv_obj_get_height(parent));
+        lv_obj_set_pos(m_obj, 0, 0);
+        lv_obj_set_click(m_obj, false);
+        lv_obj_add_style(m_obj, LV_OBJ_PART_MAIN, text_style);
+        lv_obj_set_design_cb(m_obj, design);
+
+        Dashboard **self = (Dashboard **)lv_obj_allocate_ext_attr(m_obj, sizeof(Dashboard *));
+        *self = this;
+        m_font = lv_obj_get_style_text_font(m_obj, LV_OBJ_PART_MAIN);
+      }
+
+      void add(DashboardCell *cell) {
+        if (m_count < DASHBOARD_MAX_CELLS) {
+          m_cells[m_count++] = cell;
+        }
+      }
+
+      lv_obj_t *obj() const {
+        return m_obj;
+      }
+
+      const lv_font_t *font() const {
+        return m_font;
+      }
+
+      lv_coord_t textWidth(const char *text) const {
+        return _lv_txt_get_width(text, strlen(text), m_font, 0, LV_TXT_FLAG_NONE);
+      }
+
+    private:
+      lv_obj_t *m_obj = NULL;
+      const lv_font_t *m_font = NULL;
+      DashboardCell *m_cells[DASHBOARD_MAX_CELLS];
+      uint8_t m_count = 0;
+
+      // Only the cells are drawn, the object itself has no background
+      static lv_design_res_t design(lv_obj_t *obj, const lv_area_t *clip, lv_design_mode_t mode) {
+        if (mode == LV_DESIGN_COVER_CHK) {
+          return LV_DESIGN_RES_NOT_COVER;
+        }
+        if (mode == LV_DESIGN_DRAW_MAIN) {
+          Dashboard *dash = *(Dashboard **)lv_obj_get_ext_attr(obj);
+          lv_draw_label_dsc_t dsc;
+          lv_draw_label_dsc_init(&dsc);
+          lv_obj_init_draw_label_dsc(obj, LV_OBJ_PART_MAIN, &dsc);
+          for (uint8_t i = 0; i < dash->m_count; i++) {
+            dash->m_cells[i]->draw(clip, &dsc);
+          }
+        }
+        return LV_DESIGN_RES_OK;
+      }
+  };
+
+  inline void DashboardCell::bind(Dashboard &dash, lv_obj_t *body, lv_coord_t x, lv_coord_t y, const char *caption,
+                                  lv_coord_t valueX, uint8_t decimals, const char *suffix) {
+    lv_area_t origin;
+    lv_area_t at;
+    lv_obj_get_coords(dash.obj(), &origin);
+    lv_obj_get_coords(body, &at);
+
+    m_dash = &dash;
+    m_x = at.x1 - origin.x1 + x;
+    m_y = at.y1 - origin.y1 + y;
+    m_valueX = at.x1 - origin.x1 + valueX;
+    m_caption = caption;
+    m_captionWidth = dash.textWidth(caption);
+    m_decimals = decimals;
+    m_suffix = suffix;
+    m_text = "";
+    m_valueWidth = 0;
+    m_valid = false;
+    dash.add(this);
+  }
+
+  inline void DashboardCell::captionArea(lv_area_t *area) const {
+    lv_obj_get_coords(m_dash->obj(), area);
+    area->x1 += m_x;
+    area->y1 += m_y;
+    area->x2 = area->x1 + m_captionWidth - 1;
+    area->y2 = area->y1 + lv_font_get_line_height(m_dash->font()) - 1;
+  }
+
+  inline void DashboardCell::valueArea(lv_area_t *area) const {
+    lv_obj_get_coords(m_dash->obj(), area);
+    area->x1 += m_valueX;
+    area->y1 += m_y;
+    area->x2 = area->x1 + m_valueWidth - 1;
+    area->y2 = area->y1 + lv_font_get_line_height(m_dash->font()) - 1;
+  }
+
+  // Invalidate whichever of the old and new text is wider
+  inline void DashboardCell::show(const char *text) {
+    lv_coord_t width = m_dash->textWidth(text);
+    if (width > m_valueWidth) {
+      m_valueWidth = width;
+    }
+
+    lv_area_t area;
+    valueArea(&area);
+    lv_obj_invalidate_area(m_dash->obj(), &area);
+
+    m_text = text;
+    m_valueWidth = width;
+    m_valid = true;
+  }
+
+  inline void DashboardCell::draw(const lv_area_t *clip, const lv_draw_label_dsc_t *dsc) const {
+    lv_area_t area;
+    captionArea(&area);
+    if (area.y1 > clip->y2 || area.y2 < clip->y1) {
+      return;
+    }
+    if (area.x1 <= clip->x2 && area.x2 >= clip->x1) {
+      lv_draw_label(&area, clip, dsc, m_caption, NULL);
+    }
+
+    valueArea(&area);
+    if (m_valueWidth > 0 && area.x1 <= clip->x2 && area.x2 >= clip->x1) {
+      lv_draw_label(&area, clip, dsc, m_text, NULL);
+    }
+  }
+
+#endif
@@ -3,7 +3,9 @@
   */
 #ifndef _FT62XXTouchScreen_H_
 
+#include <Arduino.h>
 #include <Wire.h>
+#include "I2CBus.h"
 
   #define _FT62XXTouchScreen_H_ 1
 
@@ -14,6 +16,7 @@
   #define FT62XX_REG_FACTORYMODE 0x40 //!< Factory mode
   #define FT62XX_REG_THRESHHOLD 0x80  //!< Threshold for touch detection
   #define FT62XX_REG_POINTRATE 0x88   //!< Point rate
+  #define FT62XX_REG_GMODE 0xA4       //!< Interrupt mode, polling or trigger
   #define FT62XX_REG_FIRMVERS 0xA6    //!< Firmware version
   #define FT62XX_REG_CHIPID 0xA3      //!< Chip selecting
   #define FT62XX_REG_VENDID 0xA8      //!< FocalTech's panel ID
@@ -23,12 +26,34 @@
   #define FT6236_CHIPID 0x36  //!< Chip selecting
   #define FT6236U_CHIPID 0x64 //!< Chip selecting
 
+  #define FT62XX_GMODE_TRIGGER 0x01 //!< INT pulses low once per report
+
+  #define FT62XX_REG_STATUS 0x02      //!< Number of touch points, P1 and P2 follow
+  #define FT62XX_POINT_SIZE 6         //!< XH, XL, YH, YL, weight, area per point
+  #define FT62XX_MAX_POINTS 2
+
+  // Event flag in the top bits of XH
+  #define FT62XX_EVENT_DOWN 0x00
+  #define FT62XX_EVENT_UP 0x01
+  #define FT62XX_EVENT_CONTACT 0x02
+  #define FT62XX_EVENT_NONE 0x03
+
   typedef struct TouchPoint {
     uint16_t xPos;
     uint16_t yPos;
-    uint16_t touched;
+    bool touched;
   } TouchPoint;
 
+  typedef struct TouchPoints {
+    uint8_t count;
+    struct {
+      uint16_t xPos;
+      uint16_t yPos;
+      uint8_t id;
+      uint8_t event; // FT62XX_EVENT_*
+    } point[FT62XX_MAX_POINTS];
+  } TouchPoints;
+
   class FT62XXTouchScreen {
 
     public:
@@ -72,88 +97,111 @@
         return true;
       }
 
+      /*
+       * Read the controller only after its INT line pulsed, or while a touch is
+       * held. Otherwise read() returns the last point without bus traffic.
+       */
+      void enableInterrupt(uint8_t pin) {
+        writeByteToTouch(FT62XX_REG_GMODE, FT62XX_GMODE_TRIGGER);
+        pinMode(pin, INPUT);
+        m_pending = true;
+        m_interrupt = true;
+        attachInterruptArg(digitalPinToInterrupt(pin), onInterrupt, this, FALLING);
+      }
+
       TouchPoint read(void) {
-  
-        TouchPoint retPoint = {0};
-      
-        uint8_t i2cdat[16];
-        Wire.beginTransmission(FT62XX_ADDR);
-        Wire.write((byte)0);
-        Wire.endTransmission();
-      
-        Wire.requestFrom((byte)FT62XX_ADDR, (byte)16);
-        for (uint8_t i = 0; i < 16; i++) {
-          i2cdat[i] = Wire.read();
-        }
-      
-        #ifdef TOUCHSCREEN_DEBUG
-          for (int16_t i = 0; i < 16; i++) {
-            Serial.print("I2C $");
-            Serial.print(i, HEX);
-            Serial.print(" = 0x");
-            Serial.println(i2cdat[i], HEX);
+        if (m_interrupt) {
+          if (!m_pending && !m_last.touched) {
+            return m_last;
           }
-        #endif
-      
-        uint8_t touches = i2cdat[0x02];
-      
-        if (touches != 1) {
-          return retPoint;
+          m_pending = false;
         }
-        
+        TouchPoints points;
+        m_last.touched = false;
+        if (readPoints(points) && points.point[0].event != FT62XX_EVENT_UP) {
+          m_last.xPos = points.point[0].xPos;
+          m_last.yPos = points.point[0].yPos;
+          m_last.touched = true;
+        }
+        return m_last;
+      }
+
+      /*
+       * Both points in screen coordinates. Reads the 3 status registers plus
+       * 6 per point, sized by the touch count of the previous read; a second
+       * transfer fetches the rest when more points appear. Returns count > 0.
+       */
+      bool readPoints(TouchPoints &points) {
+        uint8_t regs[3 + FT62XX_POINT_SIZE * FT62XX_MAX_POINTS];
+        uint8_t len = 3 + FT62XX_POINT_SIZE * m_points;
+        if (!readRegisters(0x00, regs, len)) {
+          points.count = 0;
+          return false;
+        }
+
+        uint8_t touches = regs[FT62XX_REG_STATUS] & 0x0F;
+        if (touches > FT62XX_MAX_POINTS) {
+          touches = 0; // 0x0F after power up, no valid data
+        }
+        uint8_t needed = 3 + FT62XX_POINT_SIZE * touches;
+        if (needed > len && !readRegisters(len, regs + len, needed - len)) {
+          touches = 0;
+        }
+        m_points = touches;
+
         #ifdef TOUCHSCREEN_DEBUG
           Serial.print("# Touches: ");
           Serial.println(touches);
-        
-          for (uint8_t i = 0; i < 16; i++) {
-            Serial.print("0x");
-            Serial.print(i2cdat[i], HEX);
-            Serial.print(" ");
-          }
-          Serial.println();
-          if (i2cdat[0x01] != 0x00) {
+          if (regs[0x01] != 0x00) {
             Serial.print("Gesture #");
-            Serial.println(i2cdat[0x01]);
+            Serial.println(regs[0x01]);
           }
         #endif
-  
-        uint16_t touchY = i2cdat[0x03] & 0x0F;
-        touchY <<= 8;
-        touchY |= i2cdat[0x04];
-        uint16_t touchX = i2cdat[0x05] & 0x0F;
-        touchX <<= 8;
-        touchX |= i2cdat[0x06];
-        uint16_t touchID = i2cdat[0x05] >> 4;
-      
-        #ifdef TOUCHSCREEN_DEBUG
-          Serial.println();
-          for (uint8_t i = 0; i < touches; i++) {
-            Serial.print("ID #");
-            Serial.print(touchID);
-            Serial.print("\t(");
-            Serial.print(touchX);
-            Serial.print(", ");
-            Serial.print(touchY);
-            Serial.print(") ");
-          }
-          Serial.println();
-        #endif
-      
-        touchY = m_displayHeight - touchY;
 
-        retPoint.xPos = touchX;
-        retPoint.yPos = touchY;
-        retPoint.touched = -1;
-      
-        return retPoint;
+        points.count = touches;
+        for (uint8_t i = 0; i < touches; i++) {
+          const uint8_t *p = regs + 3 + FT62XX_POINT_SIZE * i;
+          // The panel is mounted rotated: P_X is the screen Y axis, flipped
+          uint16_t rawX = ((p[0] & 0x0F) << 8) | p[1];
+          uint16_t rawY = ((p[2] & 0x0F) << 8) | p[3];
+          points.point[i].xPos = rawY;
+          points.point[i].yPos = m_displayHeight - rawX;
+          points.point[i].id = p[2] >> 4;
+          points.point[i].event = p[0] >> 6;
+        }
+        return touches > 0;
       }
 
     private:
       uint16_t m_displayHeight;
       uint8_t m_sda;
       uint8_t m_scl;
+      bool m_interrupt = false;
+      volatile bool m_pending = false;
+      TouchPoint m_last = {0};
+      uint8_t m_points = 0; // Touch count of the last read, sizes the next one
+
+      static void IRAM_ATTR onInterrupt(void *arg) {
+        ((FT62XXTouchScreen *)arg)->m_pending = true;
+      }
+
+      bool readRegisters(uint8_t reg, uint8_t *data, uint8_t len) {
+        I2CLock bus;
+        Wire.beginTransmission(FT62XX_ADDR);
+        Wire.write(reg);
+        Wire.endTransmission();
+
+        if (Wire.requestFrom((byte)FT62XX_ADDR, len) != len) {
+          return false;
+        }
+        for (uint8_t i = 0; i < len; i++) {
+          data[i] = Wire.read();
+        }
+        return true;
+      }
 
       uint8_t readByteFromTouch(uint8_t reg) {
+        I2CLock bus;
         Wire.beginTransmission(FT62XX_ADDR);
         Wire.write((byte)reg);
         Wire.endTransmission();
@@ -170,6 +218,7 @@
       }
       
       void writeByteToTouch(uint8_t reg, uint8_t val) {
+        I2CLock bus;
         Wire.beginTransmission(FT62XX_ADDR);
         Wire.write((byte)reg);
         Wire.write((byte)val);
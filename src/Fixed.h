@@ -0,0 +1,70 @@
+/*
+ * Fixed-point measurement values, stored as int32 thousandths (milli-units)
+ *
+ * The ESP32 FPU is single precision only, so every double operation is a
+ * libgcc soft-float call. Doubles are only used where the I2C packets need them.
+ */
+#ifndef _Fixed_H_
+
+#include <stdint.h>
+
+  #define _Fixed_H_ 1
+
+  typedef int32_t milli_t;
+
+  #define MILLI_ONE 1000
+
+  // For constants only, so the conversion folds at compile time
+  #define MILLI(x) ((milli_t)((x) * MILLI_ONE + ((x) < 0 ? -0.5 : 0.5)))
+
+  // Round to `decimals` places (0 to 3), half away from zero, scaled by 10^decimals
+  static inline int32_t milli_round(milli_t v, uint8_t decimals) {
+    static const int32_t divisor[] = {1000, 100, 10, 1};
+    int32_t d = divisor[decimals];
+    return (v + (v < 0 ? -d / 2 : d / 2)) / d;
+  }
+
+  /*
+   * Print `v` with `decimals` places followed by `suffix` into `buf`, using
+   * integer math only. Returns the length, the text is always terminated.
+   */
+  static inline uint8_t milli_format(char *buf, uint8_t size, milli_t v, uint8_t decimals, const char *suffix) {
+    int32_t r = milli_round(v, decimals);
+    uint32_t u = r < 0 ? -(uint32_t)r : (uint32_t)r;
+
+    char digits[11];
+    uint8_t n = 0;
+    do {
+      digits[n++] = '0' + u % 10;
+      u /= 10;
+    } while (u || n <= decimals);
+
+    uint8_t len = 0;
+    if (r < 0 && len < size - 1) {
+      buf[len++] = '-';
+    }
+    while (n && len < size - 1) {
+      if (n == decimals) {
+        buf[len++] = '.';
+        if (len == size - 1) {
+          break;
+        }
+      }
+      buf[len++] = digits[--n];
+    }
+    while (*suffix && len < size - 1) {
+      buf[len++] = *suffix++;
+    }
+    buf[len] = 0;
+    return len;
+  }
+
+  static inline milli_t milli_from_double(double v) {
+    return (milli_t)(v * MILLI_ONE + (v < 0 ? -0.5 : 0.5));
+  }
+
+  static inline double milli_to_double(milli_t v) {
+    return (double)v / MILLI_ONE;
+  }
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Streams LVGL flush areas to the panel with as few address windows as possible
+ *
+ * The only saving is an area that continues the previous one: same columns,
+ * first row right below it. That is what LVGL sends when an area is taller
+ * than the draw buffer and goes out in bands. Areas side by side or apart,
+ * like the value texts, each still get their own window.
+ */
+#ifndef _FlushScheduler_H_
+
+#include <TFT_eSPI.h>
+#include "lvgl.h"
+
+  #define _FlushScheduler_H_ 1
+
+  typedef struct FlushStats {
+    uint32_t transactions; // CASET/RASET/RAMWR sequences sent
+    uint32_t areas;        // Areas handed over by LVGL
+    uint32_t bytes;        // Pixel bytes pushed
+  } FlushStats;
+
+  class FlushScheduler {
+
+    public:
+      FlushScheduler(TFT_eSPI &lcd) : m_lcd(lcd) {
+      }
+
+      // Push one area; `last` is lv_disp_flush_is_last() for the refresh cycle
+      void push(const lv_area_t *area, uint16_t *pixels, bool last) {
+        uint32_t w = (area->x2 - area->x1 + 1);
+        uint32_t h = (area->y2 - area->y1 + 1);
+
+        // Previous area must be out of the other buffer before the window moves
+        m_lcd.dmaWait();
+
+        if (!continues(area)) {
+          // Open the window down to the bottom row. A following area with the
+          // same columns starting on the next row then streams straight in
+          // without another CASET/RASET/RAMWR.
+          m_lcd.setAddrWindow(area->x1, area->y1, w, m_lcd.height() - area->y1);
+          m_current.transactions++;
+        }
+        m_lcd.pushPixelsDMA(pixels, w * h);
+
+        m_open = true;
+        m_x1 = area->x1;
+        m_x2 = area->x2;
+        m_nextY = area->y2 + 1;
+
+        m_current.areas++;
+        m_current.bytes += w * h * sizeof(uint16_t);
+        m_pixels += w * h;
+
+        if (last) {
+          m_lastFrame = m_current;
+          m_total.transactions += m_current.transactions;
+          m_total.areas += m_current.areas;
+          m_total.bytes += m_current.bytes;
+          m_current = {0};
+        }
+      }
+
+      // Counters of the last completed refresh cycle
+      const FlushStats &lastFrame() const {
+        return m_lastFrame;
+      }
+
+      // Completed refresh cycles since boot
+      const FlushStats &total() const {
+        return m_total;
+      }
+
+      // Pixels pushed since the previous call
+      uint32_t takePixels() {
+        uint32_t pixels = m_pixels;
+        m_pixels = 0;
+        return pixels;
+      }
+
+    private:
+      TFT_eSPI &m_lcd;
+      FlushStats m_current = {0};
+      FlushStats m_lastFrame = {0};
+      FlushStats m_total = {0};
+      uint32_t m_pixels = 0;
+
+      bool m_open = false;
+      lv_coord_t m_x1 = 0;
+      lv_coord_t m_x2 = 0;
+      lv_coord_t m_nextY = 0;
+
+      // Nothing is merged here. LVGL joins invalidated areas only when the
+      // union is smaller than the two, so others arrive one by one.
+      bool continues(const lv_area_t *area) const {
+        return m_open && area->x1 == m_x1 && area->x2 == m_x2 && area->y1 == m_nextY;
+      }
+
+  };
+
+#endif
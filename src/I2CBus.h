@@ -0,0 +1,56 @@
+/*
+ * One mutex for the I2C bus, shared by the touch controller and the sensor link
+ *
+ * The Wire lock on the target only covers a single call. The read()s after
+ * requestFrom() come out of Wire's one receive buffer, so another task's
+ * transfer in between hands over its bytes instead. Hold an I2CLock across
+ * each whole write/requestFrom/read sequence.
+ */
+#ifndef _I2CBus_H_
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+  #define _I2CBus_H_ 1
+
+  class I2CBus {
+
+    public:
+      // Before the tasks that use the bus are started
+      void begin() {
+        if (m_mutex == NULL) {
+          m_mutex = xSemaphoreCreateMutex();
+        }
+      }
+
+      void lock() {
+        if (m_mutex != NULL) {
+          xSemaphoreTake(m_mutex, portMAX_DELAY);
+        }
+      }
+
+      void unlock() {
+        if (m_mutex != NULL) {
+          xSemaphoreGive(m_mutex);
+        }
+      }
+
+    private:
+      SemaphoreHandle_t m_mutex = NULL;
+  };
+
+  extern I2CBus i2cBus;
+
+  class I2CLock {
+
+    public:
+      I2CLock() {
+        i2cBus.lock();
+      }
+
+      ~I2CLock() {
+        i2cBus.unlock();
+      }
+  };
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Touch-to-photon latency: from a touch sample to the panel showing its effect
+ *
+ * Every sample input_read() hands LVGL carries the time it was read from the
+ * FT6236. An event callback that changes the screen arms the probe with that
+ * time and the area of the object it changed. The probe completes on the
+ * first flush that reaches the bottom row of that area, as LVGL flushes each
+ * refresh area top to bottom. Only compiled in with -DPROFILER=1.
+ */
+#ifndef _LatencyProbe_H_
+
+#include <Arduino.h>
+#include "lvgl.h"
+#include "Profiler.h"
+
+  #define _LatencyProbe_H_ 1
+
+  #if PROFILER
+
+  #define PROBE_TIMEOUT_US 1000000 // A change not on the panel by then was never redrawn
+
+  class LatencyProbe {
+
+    public:
+      // Sample LVGL is about to process, stamped before its I2C read
+      void touch(uint32_t us) {
+        m_touchUs = us;
+        m_tagged = true;
+      }
+
+      // From an event callback that changed `obj`; records touch to event
+      void changed(lv_obj_t *obj) {
+        if (!m_tagged) {
+          return;
+        }
+        if (m_armed) {
+          m_superseded++;
+        }
+        lv_obj_get_coords(obj, &m_area);
+        lv_coord_t bottom = lv_disp_get_ver_res(NULL) - 1;
+        if (m_area.y2 > bottom) {
+          m_area.y2 = bottom;
+        }
+        m_startUs = m_touchUs;
+        m_armed = true;
+        m_probes++;
+        profiler.recordUs(PROF_EVENT, micros() - m_startUs);
+      }
+
+      // From disp_flush with the area just pushed. True when it completes the
+      // change: wait for the transfer, then call landed().
+      bool covers(const lv_area_t *area) {
+        if (!m_armed) {
+          return false;
+        }
+        if (micros() - m_startUs > PROBE_TIMEOUT_US) {
+          m_armed = false;
+          m_timedOut++;
+          return false;
+        }
+        return area->y2 >= m_area.y2 && _lv_area_is_on(area, &m_area);
+      }
+
+      void landed() {
+        profiler.recordUs(PROF_PHOTON, micros() - m_startUs);
+        m_armed = false;
+      }
+
+      uint32_t probes() const {
+        return m_probes;
+      }
+
+      // Changed again before the previous change reached the panel
+      uint32_t superseded() const {
+        return m_superseded;
+      }
+
+      uint32_t timedOut() const {
+        return m_timedOut;
+      }
+
+    private:
+      uint32_t m_touchUs = 0;
+      uint32_t m_startUs = 0;
+      lv_area_t m_area;
+      bool m_tagged = false;
+      bool m_armed = false;
+      uint32_t m_probes = 0;
+      uint32_t m_superseded = 0;
+      uint32_t m_timedOut = 0;
+  };
+
+  extern LatencyProbe latencyProbe;
+
+  #define PROBE_CHANGED(obj) latencyProbe.changed(obj)
+
+  #else
+
+  #define PROBE_CHANGED(obj)
+
+  #endif
+
+#endif
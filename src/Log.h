@@ -0,0 +1,137 @@
+/*
+ * Asynchronous logging: messages are formatted into a ring and written to
+ * Serial by a low-priority task, so a full UART FIFO never stalls the caller
+ *
+ * LOG_LEVEL picks what is compiled in. Macros above it expand to nothing and
+ * their arguments are not evaluated. A message that finds the ring full is
+ * dropped and counted, and the drain task reports the count.
+ */
+#ifndef _Log_H_
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "MpscRing.h"
+
+  #define _Log_H_ 1
+
+  #define LOG_LEVEL_NONE 0
+  #define LOG_LEVEL_ERROR 1
+  #define LOG_LEVEL_WARN 2
+  #define LOG_LEVEL_INFO 3
+  #define LOG_LEVEL_DEBUG 4
+  #define LOG_LEVEL_TRACE 5
+
+  #ifndef LOG_LEVEL
+    #define LOG_LEVEL LOG_LEVEL_INFO
+  #endif
+
+  #if LOG_LEVEL > LOG_LEVEL_NONE
+
+  #define LOG_LINE 56          // Message bytes kept, longer ones are cut
+  #define LOG_RING_SIZE 32     // Messages queued before they drop
+  #define LOG_DRAIN_MS 20
+  #define LOG_TASK_STACK 2048
+  #define LOG_TASK_PRIO 1      // Above idle only
+
+  typedef struct LogEntry {
+    uint32_t ms;
+    uint8_t level;
+    char text[LOG_LINE];
+  } LogEntry;
+
+  class Logger {
+
+    public:
+      bool begin(BaseType_t core) {
+        return xTaskCreatePinnedToCore(run, "log", LOG_TASK_STACK, this, LOG_TASK_PRIO, NULL, core) == pdPASS;
+      }
+
+      // From any task; never blocks
+      __attribute__((format(printf, 3, 4)))
+      void message(uint8_t level, const char *format, ...) {
+        LogEntry entry;
+        entry.ms = millis();
+        entry.level = level;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(entry.text, sizeof entry.text, format, args);
+        va_end(args);
+        if (!m_ring.push(entry)) {
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+
+      uint32_t dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+      }
+
+    private:
+      MpscRing<LogEntry, LOG_RING_SIZE> m_ring;
+      std::atomic<uint32_t> m_dropped{0};
+      uint32_t m_reported = 0;
+
+      static void run(void *arg) {
+        Logger *self = (Logger *)arg;
+        for (;;) {
+          self->drain();
+          vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+        }
+      }
+
+      // Blocks on the UART here, in the log task, instead of in the caller
+      void drain() {
+        static const char levels[] = "?EWIDT";
+        char line[LOG_LINE + 16];
+        LogEntry entry;
+        while (m_ring.pop(entry)) {
+          int n = snprintf(line, sizeof line, "%lu %c %s\r\n", (unsigned long)entry.ms, levels[entry.level], entry.text);
+          Serial.write((const uint8_t *)line, n < (int)sizeof line ? n : sizeof line - 1);
+        }
+        uint32_t dropped = this->dropped();
+        if (dropped != m_reported) {
+          int n = snprintf(line, sizeof line, "log: %lu messages dropped\r\n", (unsigned long)(dropped - m_reported));
+          Serial.write((const uint8_t *)line, n);
+          m_reported = dropped;
+        }
+      }
+  };
+
+  extern Logger logger;
+
+  #endif
+
+  #if LOG_LEVEL >= LOG_LEVEL_ERROR
+    #define LOG_ERROR(...) logger.message(LOG_LEVEL_ERROR, __VA_ARGS__)
+  #else
+    #define LOG_ERROR(...) do {} while (0)
+  #endif
+
+  #if LOG_LEVEL >= LOG_LEVEL_WARN
+    #define LOG_WARN(...) logger.message(LOG_LEVEL_WARN, __VA_ARGS__)
+  #else
+    #define LOG_WARN(...) do {} while (0)
+  #endif
+
+  #if LOG_LEVEL >= LOG_LEVEL_INFO
+    #define LOG_INFO(...) logger.message(LOG_LEVEL_INFO, __VA_ARGS__)
+  #else
+    #define LOG_INFO(...) do {} while (0)
+  #endif
+
+  #if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(...) logger.message(LOG_LEVEL_DEBUG, __VA_ARGS__)
+  #else
+    #define LOG_DEBUG(...) do {} while (0)
+  #endif
+
+  #if LOG_LEVEL >= LOG_LEVEL_TRACE
+    #define LOG_TRACE(...) logger.message(LOG_LEVEL_TRACE, __VA_ARGS__)
+  #else
+    #define LOG_TRACE(...) do {} while (0)
+  #endif
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Lock-free ring for any number of producers and one consumer
+ *
+ * Each slot carries a sequence number: producers claim a slot by advancing
+ * the head with a CAS, then publish it by bumping its sequence, so a slow
+ * producer never exposes a half-written value to the consumer.
+ */
+#ifndef _MpscRing_H_
+
+#include <stdint.h>
+#include <atomic>
+
+  #define _MpscRing_H_ 1
+
+  // N must be a power of two; indices run freely and wrap at 2^16
+  template <typename T, uint16_t N>
+  class MpscRing {
+
+    static_assert((N & (N - 1)) == 0 && N <= 16384, "MpscRing size must be a power of two");
+
+    public:
+      MpscRing() {
+        for (uint16_t i = 0; i < N; i++) {
+          m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      // Producer side, from any task. False if the ring is full, the value is not queued.
+      bool push(const T &value) {
+        uint16_t head = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+          Slot &slot = m_slots[head & (N - 1)];
+          int16_t diff = (int16_t)(slot.seq.load(std::memory_order_acquire) - head);
+          if (diff == 0) {
+            if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+              slot.value = value;
+              slot.seq.store(head + 1, std::memory_order_release);
+              return true;
+            }
+          } else if (diff < 0) {
+            return false;
+          } else {
+            head = m_head.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      // Consumer side
+      bool pop(T &value) {
+        Slot &slot = m_slots[m_tail & (N - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != (uint16_t)(m_tail + 1)) {
+          return false;
+        }
+        value = slot.value;
+        slot.seq.store(m_tail + N, std::memory_order_release);
+        m_tail++;
+        return true;
+      }
+
+    private:
+      typedef struct Slot {
+        std::atomic<uint16_t> seq;
+        T value;
+      } Slot;
+
+      Slot m_slots[N];
+      std::atomic<uint16_t> m_head{0};
+      uint16_t m_tail = 0;
+  };
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ * Frame-time profiler: fixed-bucket latency histograms per stage and per lv_task
+ *
+ * Tracked lv_tasks also keep their total run time and how late each run
+ * started against its period, for the "tasks" table.
+ *
+ * Build with -DPROFILER=1 to enable. Disabled, the macros below expand to
+ * nothing (PROF_TASK to its argument) and nothing here is compiled in.
+ */
+#ifndef _Profiler_H_
+
+#include <Arduino.h>
+#include "lvgl.h"
+
+  #define _Profiler_H_ 1
+
+  #ifndef PROFILER
+    #define PROFILER 0
+  #endif
+
+  #if PROFILER
+
+  #ifndef ARDUINO_ARCH_ESP32
+    #include <chrono>
+  #endif
+
+  #define PROF_MAX_HIST 20       // Stages plus tracked lv_tasks
+  #define PROF_DUMP_PERIOD 10000 // ms between binary summaries after "prof bin on"
+
+  // 4 linear buckets, then 4 per power of two: ~19% resolution from 1 us to ~2 s
+  #define PROF_SUB_BUCKETS 4
+  #define PROF_BUCKETS 80
+
+  enum ProfStage {
+    PROF_LOOP,   // lv_task_handler() in loop()
+    PROF_RENDER, // LVGL display refresh task, flushes included
+    PROF_FLUSH,  // disp_flush()
+    PROF_INPUT,  // input_read()
+    PROF_TOUCH,  // Touch sample age when LVGL reads it
+    PROF_EVENT,  // Touch sample to the event callback it triggered
+    PROF_PHOTON, // Touch sample to its change flushed to the panel
+    PROF_GAP,    // Start of one loop() to the next
+    PROF_STAGES
+  };
+
+  // Cycle counter on target, steady_clock nanoseconds on the host
+  static inline uint32_t prof_ticks() {
+  #ifdef ARDUINO_ARCH_ESP32
+    return ESP.getCycleCount();
+  #else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  #endif
+  }
+
+  static inline uint32_t prof_ticks_to_us(uint32_t ticks) {
+  #ifdef ARDUINO_ARCH_ESP32
+    return ticks / ESP.getCpuFreqMHz();
+  #else
+    return ticks / 1000;
+  #endif
+  }
+
+  class LatencyHistogram {
+
+    public:
+      void record(uint32_t us) {
+        m_buckets[bucket(us)]++;
+        m_count++;
+        if (us > m_max) {
+          m_max = us;
+        }
+      }
+
+      void reset() {
+        memset(m_buckets, 0, sizeof m_buckets);
+        m_count = 0;
+        m_max = 0;
+      }
+
+      uint32_t count() const {
+        return m_count;
+      }
+
+      uint32_t max() const {
+        return m_max;
+      }
+
+      // Upper bound of the bucket holding the p-th percentile, capped at max
+      uint32_t percentile(uint8_t p) const {
+        if (m_count == 0) {
+          return 0;
+        }
+        uint32_t rank = ((uint64_t)m_count * p + 99) / 100;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+          seen += m_buckets[i];
+          if (seen >= rank) {
+            uint32_t upper = upperBound(i);
+            return upper < m_max ? upper : m_max;
+          }
+        }
+        return m_max;
+      }
+
+    private:
+      uint32_t m_buckets[PROF_BUCKETS] = {0};
+      uint32_t m_count = 0;
+      uint32_t m_max = 0;
+
+      static uint8_t bucket(uint32_t us) {
+        if (us < PROF_SUB_BUCKETS) {
+          return us;
+        }
+        uint8_t octave = 31 - __builtin_clz(us);
+        uint32_t i = PROF_SUB_BUCKETS * (octave - 1) + ((us >> (octave - 2)) & (PROF_SUB_BUCKETS - 1));
+        return i < PROF_BUCKETS ? i : PROF_BUCKETS - 1;
+      }
+
+      static uint32_t upperBound(uint8_t i) {
+        if (i < PROF_SUB_BUCKETS) {
+          return i;
+        }
+        uint8_t octave = i / PROF_SUB_BUCKETS + 1;
+        uint32_t lower = (PROF_SUB_BUCKETS + i % PROF_SUB_BUCKETS) << (octave - 2);
+        return lower + (1UL << (octave - 2)) - 1;
+      }
+  };
+
+  class Profiler {
+
+    public:
+      Profiler() {
+        m_names[PROF_LOOP] = "loop";
+        m_names[PROF_RENDER] = "render";
+        m_names[PROF_FLUSH] = "flush";
+        m_names[PROF_INPUT] = "input";
+        m_names[PROF_TOUCH] = "touch_age";
+        m_names[PROF_EVENT] = "tap_event";
+        m_names[PROF_PHOTON] = "photon";
+        m_names[PROF_GAP] = "loop_gap";
+        m_used = PROF_STAGES;
+      }
+
+      void record(uint8_t hist, uint32_t startTicks) {
+        m_hist[hist].record(prof_ticks_to_us(prof_ticks() - startTicks));
+      }
+
+      // For latencies measured elsewhere, such as across tasks
+      void recordUs(uint8_t hist, uint32_t us) {
+        m_hist[hist].record(us);
+      }
+
+      // Route an lv_task through a timing trampoline, into its own histogram
+      lv_task_t *track(lv_task_t *task, const char *name) {
+        if (task == NULL || m_used >= PROF_MAX_HIST) {
+          return task;
+        }
+        m_names[m_used] = name;
+        return track(task, m_used++);
+      }
+
+      // Same, recording into a fixed stage
+      lv_task_t *track(lv_task_t *task, ProfStage stage) {
+        return track(task, (uint8_t)stage);
+      }
+
+      // Runs of tracked lv_tasks since boot
+      uint32_t taskRuns() const {
+        return m_taskRuns;
+      }
+
+      void reset() {
+        for (uint8_t i = 0; i < m_used; i++) {
+          m_hist[i].reset();
+        }
+        for (uint8_t i = 0; i < m_trackedCount; i++) {
+          m_tracked[i].stats = {};
+        }
+        m_resetUs = micros();
+      }
+
+      void printReport() {
+        Serial.println("name        count    p50    p95    p99    max (us)");
+        for (uint8_t i = 0; i < m_used; i++) {
+          const LatencyHistogram &h = m_hist[i];
+          char line[80];
+          snprintf(line, sizeof line, "%-10s %6lu %6lu %6lu %6lu %6lu", m_names[i], (unsigned long)h.count(),
+                   (unsigned long)h.percentile(50), (unsigned long)h.percentile(95),
+                   (unsigned long)h.percentile(99), (unsigned long)h.max());
+          Serial.println(line);
+        }
+      }
+
+      // Per tracked lv_task: share of the time since reset and start lateness
+      void printTasks() {
+        uint32_t elapsedUs = micros() - m_resetUs;
+        Serial.println("task         runs  total ms  busy %  max us  late avg  late max (us)");
+        for (uint8_t i = 0; i < m_trackedCount; i++) {
+          const TaskStats &t = m_tracked[i].stats;
+          uint32_t permille = elapsedUs ? t.totalUs * 1000 / elapsedUs : 0;
+          char line[96];
+          snprintf(line, sizeof line, "%-10s %6lu %9lu %5lu.%lu %7lu %9lu %9lu", m_names[m_tracked[i].hist],
+                   (unsigned long)t.runs, (unsigned long)(t.totalUs / 1000), (unsigned long)(permille / 10),
+                   (unsigned long)(permille % 10), (unsigned long)t.maxUs,
+                   (unsigned long)(t.runs ? t.lateUs / t.runs : 0), (unsigned long)t.lateMaxUs);
+          Serial.println(line);
+        }
+      }
+
+      /*
+       * Compact summary frame for "prof bin" and "prof bin on", little endian:
+       *   0xA5 0x5A, count (u8), then per histogram id (u8) and
+       *   count, p50, p95, p99, max (u32 each), then the XOR of all payload bytes
+       */
+      void writeBinary() {
+        uint8_t frame[3 + PROF_MAX_HIST * 21 + 1];
+        uint16_t n = 0;
+        frame[n++] = 0xA5;
+        frame[n++] = 0x5A;
+        frame[n++] = m_used;
+        for (uint8_t i = 0; i < m_used; i++) {
+          const LatencyHistogram &h = m_hist[i];
+          frame[n++] = i;
+          n = put32(frame, n, h.count());
+          n = put32(frame, n, h.percentile(50));
+          n = put32(frame, n, h.percentile(95));
+          n = put32(frame, n, h.percentile(99));
+          n = put32(frame, n, h.max());
+        }
+        uint8_t check = 0;
+        for (uint16_t i = 2; i < n; i++) {
+          check ^= frame[i];
+        }
+        frame[n++] = check;
+        Serial.write(frame, n);
+      }
+
+      static void trampoline(lv_task_t *task);
+
+    private:
+      typedef struct TaskStats {
+        uint32_t runs;
+        uint64_t totalUs;
+        uint32_t maxUs;
+        uint64_t lateUs;
+        uint32_t lateMaxUs;
+      } TaskStats;
+
+      typedef struct Tracked {
+        lv_task_t *task;
+        lv_task_cb_t cb;
+        uint8_t hist;
+        uint32_t lastUs; // Start of the previous run, or when tracking began
+        TaskStats stats;
+      } Tracked;
+
+      LatencyHistogram m_hist[PROF_MAX_HIST];
+      const char *m_names[PROF_MAX_HIST];
+      uint8_t m_used;
+
+      Tracked m_tracked[PROF_MAX_HIST];
+      uint8_t m_trackedCount = 0;
+      uint32_t m_taskRuns = 0;
+      uint32_t m_resetUs = 0;
+
+      lv_task_t *track(lv_task_t *task, uint8_t hist) {
+        if (task == NULL) {
+          return task;
+        }
+        // A deleted task's slot is taken over by a new task at the same address
+        uint8_t i = 0;
+        while (i < m_trackedCount && m_tracked[i].task != task) {
+          i++;
+        }
+        if (i == PROF_MAX_HIST) {
+          return task;
+        }
+        if (i == m_trackedCount) {
+          m_trackedCount++;
+        }
+        m_tracked[i] = {task, task->task_cb, hist, (uint32_t)micros(), {}};
+        task->task_cb = trampoline;
+        return task;
+      }
+
+      static uint16_t put32(uint8_t *buf, uint16_t n, uint32_t v) {
+        buf[n++] = v;
+        buf[n++] = v >> 8;
+        buf[n++] = v >> 16;
+        buf[n++] = v >> 24;
+        return n;
+      }
+  };
+
+  extern Profiler profiler;
+
+  inline void Profiler::trampoline(lv_task_t *task) {
+    for (uint8_t i = 0; i < profiler.m_trackedCount; i++) {
+      Tracked &t = profiler.m_tracked[i];
+      if (t.task == task) {
+        // Runs made early by lv_task_ready() count as on time
+        uint32_t startUs = micros();
+        int32_t late = (int32_t)(startUs - t.lastUs - task->period * 1000);
+        t.lastUs = startUs;
+
+        uint32_t start = prof_ticks();
+        t.cb(task);
+        uint32_t us = prof_ticks_to_us(prof_ticks() - start);
+        profiler.recordUs(t.hist, us);
+        profiler.m_taskRuns++;
+
+        TaskStats &stats = t.stats;
+        stats.runs++;
+        stats.totalUs += us;
+        if (us > stats.maxUs) {
+          stats.maxUs = us;
+        }
+        if (late > 0) {
+          stats.lateUs += late;
+          if ((uint32_t)late > stats.lateMaxUs) {
+            stats.lateMaxUs = late;
+          }
+        }
+        return;
+      }
+    }
+  }
+
+  class ProfilerScope {
+
+    public:
+      ProfilerScope(ProfStage stage) : m_stage(stage), m_start(prof_ticks()) {
+      }
+
+      ~ProfilerScope() {
+        profiler.record(m_stage, m_start);
+      }
+
+    private:
+      ProfStage m_stage;
+      uint32_t m_start;
+  };
+
+  #define PROF_SCOPE(stage) ProfilerScope _prof_scope(stage)
+  #define PROF_TASK(task, name) profiler.track((task), (name))
+
+  #else
+
+  #define PROF_SCOPE(stage)
+  #define PROF_TASK(task, name) ((void)(task)) // Still creates the task
+
+  #endif
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Multi-resolution time series: one-second samples rolled up into every chart
+ * interval at once (1 s, 10 s, 1 min, 10 min, 30 min, 1 h, 2 h)
+ */
+#ifndef _RollupStore_H_
+
+#include <stdint.h>
+#include "SeriesRing.h"
+
+  #define _RollupStore_H_ 1
+
+  #define ROLLUP_LEVELS 7
+
+  // Largest sample magnitude: a 2 h bucket sums 7200 of them in an int32_t.
+  // Samples beyond it are clamped on add().
+  #define ROLLUP_VALUE_MAX (INT32_MAX / 7200)
+
+  typedef struct Rollup {
+    int32_t sum;
+    int32_t min;
+    int32_t max;
+    uint16_t count;
+  } Rollup;
+
+  class RollupStore {
+
+    public:
+      // `storage` holds the sum of `capacity` buckets, laid out level after level
+      RollupStore(Rollup *storage, const uint16_t *capacity) {
+        for (uint8_t i = 0; i < ROLLUP_LEVELS; i++) {
+          m_levels[i].attach(storage, capacity[i]);
+          storage += capacity[i];
+        }
+        clear();
+      }
+
+      void clear() {
+        for (uint8_t i = 0; i < ROLLUP_LEVELS; i++) {
+          m_levels[i].clear();
+          m_partial[i] = {0, INT32_MAX, INT32_MIN, 0};
+          m_children[i] = 0;
+        }
+      }
+
+      /*
+       * Add a one-second sample. A completed bucket is merged into the level
+       * above, so the cost is one merge per level that closes, seven at most.
+       * Returns a bit per level that closed a bucket.
+       */
+      uint8_t add(int32_t value) {
+        if (value > ROLLUP_VALUE_MAX) {
+          value = ROLLUP_VALUE_MAX;
+        } else if (value < -ROLLUP_VALUE_MAX) {
+          value = -ROLLUP_VALUE_MAX;
+        }
+        Rollup r = {value, value, value, 1};
+        uint8_t completed = 0;
+        for (uint8_t i = 0; i < ROLLUP_LEVELS; i++) {
+          merge(m_partial[i], r);
+          if (++m_children[i] < ratio(i)) {
+            break;
+          }
+          r = m_partial[i];
+          m_levels[i].push(r);
+          m_partial[i] = {0, INT32_MAX, INT32_MIN, 0};
+          m_children[i] = 0;
+          completed |= 1 << i;
+        }
+        return completed;
+      }
+
+      // Closed buckets of one level, oldest first
+      const SeriesRing<Rollup> &level(uint8_t i) const {
+        return m_levels[i];
+      }
+
+      static int32_t mean(const Rollup &r) {
+        if (r.count == 0) {
+          return 0;
+        }
+        int32_t half = r.sum < 0 ? -(r.count / 2) : r.count / 2;
+        return (r.sum + half) / r.count;
+      }
+
+    private:
+      SeriesRing<Rollup> m_levels[ROLLUP_LEVELS];
+      Rollup m_partial[ROLLUP_LEVELS];
+      uint8_t m_children[ROLLUP_LEVELS];
+
+      // Buckets of the level below that make one bucket of level i
+      static uint8_t ratio(uint8_t i) {
+        static const uint8_t ratios[ROLLUP_LEVELS] = {1, 10, 6, 10, 3, 2, 2};
+        return ratios[i];
+      }
+
+      static void merge(Rollup &into, const Rollup &r) {
+        into.sum += r.sum;
+        into.count += r.count;
+        if (r.min < into.min) {
+          into.min = r.min;
+        }
+        if (r.max > into.max) {
+          into.max = r.max;
+        }
+      }
+  };
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Screen navigation driven by LV_EVENT_CLICKED on linked buttons
+ *
+ * Each route returns its screen from an enter hook, building it first if
+ * needed, and may tear it down in a leave hook once another screen is
+ * loaded. The transition hook runs after every change.
+ */
+#ifndef _ScreenRouter_H_
+
+#include <stdint.h>
+#include "lvgl.h"
+
+  #define _ScreenRouter_H_ 1
+
+  #define ROUTER_MAX_SCREENS 4
+  #define ROUTER_MAX_LINKS 4
+  #define ROUTER_NONE 0xFF
+
+  typedef lv_obj_t *(*screen_enter_t)();
+  typedef void (*screen_leave_t)(lv_obj_t *screen);
+  typedef void (*screen_transition_t)(uint8_t from, uint8_t to);
+
+  class ScreenRouter {
+
+    public:
+      void add(uint8_t id, const char *name, screen_enter_t enter, screen_leave_t leave = NULL) {
+        if (id < ROUTER_MAX_SCREENS) {
+          m_routes[id] = {name, enter, leave};
+        }
+      }
+
+      void onTransition(screen_transition_t hook) {
+        m_transition = hook;
+      }
+
+      // Takes over the button's event callback; the link goes with the button
+      void link(lv_obj_t *btn, uint8_t id) {
+        uint8_t i = find(btn);
+        if (i == ROUTER_MAX_LINKS) {
+          i = find(NULL);
+        }
+        if (i == ROUTER_MAX_LINKS) {
+          return;
+        }
+        m_links[i] = {btn, id};
+        lv_obj_set_event_cb(btn, clicked);
+      }
+
+      void go(uint8_t id) {
+        if (id >= ROUTER_MAX_SCREENS || m_routes[id].enter == NULL || id == m_current) {
+          return;
+        }
+        lv_obj_t *screen = m_routes[id].enter();
+        if (screen == NULL) {
+          return;
+        }
+        lv_obj_t *old = lv_scr_act();
+        uint8_t from = m_current;
+        lv_scr_load(screen);
+        m_current = id;
+        if (from != ROUTER_NONE && m_routes[from].leave) {
+          m_routes[from].leave(old);
+        }
+        m_transitions++;
+        if (m_transition) {
+          m_transition(from, id);
+        }
+      }
+
+      // One-shot timer, e.g. off the splash screen
+      lv_task_t *goAfter(uint8_t id, uint32_t ms) {
+        lv_task_t *task = lv_task_create(timer, ms, LV_TASK_PRIO_MID, (void *)(uintptr_t)id);
+        lv_task_set_repeat_count(task, 1);
+        return task;
+      }
+
+      uint8_t current() const {
+        return m_current;
+      }
+
+      const char *name(uint8_t id) const {
+        return id < ROUTER_MAX_SCREENS && m_routes[id].name ? m_routes[id].name : "none";
+      }
+
+      uint32_t transitions() const {
+        return m_transitions;
+      }
+
+    private:
+      typedef struct Route {
+        const char *name;
+        screen_enter_t enter;
+        screen_leave_t leave;
+      } Route;
+
+      typedef struct Link {
+        lv_obj_t *btn;
+        uint8_t id;
+      } Link;
+
+      Route m_routes[ROUTER_MAX_SCREENS] = {};
+      Link m_links[ROUTER_MAX_LINKS] = {};
+      screen_transition_t m_transition = NULL;
+      uint8_t m_current = ROUTER_NONE;
+      uint32_t m_transitions = 0;
+
+      uint8_t find(lv_obj_t *btn) const {
+        uint8_t i = 0;
+        while (i < ROUTER_MAX_LINKS && m_links[i].btn != btn) {
+          i++;
+        }
+        return i;
+      }
+
+      static void clicked(lv_obj_t *btn, lv_event_t e);
+      static void timer(lv_task_t *task);
+  };
+
+  extern ScreenRouter router;
+
+  inline void ScreenRouter::clicked(lv_obj_t *btn, lv_event_t e) {
+    uint8_t i = router.find(btn);
+    if (i == ROUTER_MAX_LINKS) {
+      return;
+    }
+    if (e == LV_EVENT_DELETE) {
+      router.m_links[i].btn = NULL;
+    } else if (e == LV_EVENT_CLICKED) {
+      router.go(router.m_links[i].id);
+    }
+  }
+
+  inline void ScreenRouter::timer(lv_task_t *task) {
+    router.go((uint8_t)(uintptr_t)task->user_data);
+  }
+
+#endif
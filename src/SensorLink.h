@@ -0,0 +1,220 @@
+/*
+ * Sensor controller link and control loop in their own task, off the GUI core
+ *
+ * Every SENSOR_PERIOD_MS the task steps the test readings, checks the
+ * controller, reads its measurements and writes the thresholds over I2C,
+ * then publishes the measurements as one snapshot for the GUI. Thresholds
+ * come the other way, published by the GUI when they change. The GUI never
+ * waits on the task or the bus, and neither side ever sees half a frame. The
+ * task shares the bus with the touch sampler through I2CBus.h.
+ */
+#ifndef _SensorLink_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "Fixed.h"
+#include "Snapshot.h"
+#include "I2CBus.h"
+#include "Log.h"
+
+  #define _SensorLink_H_ 1
+
+  #define SENSOR_ADDRESS 0x08
+  #define SENSOR_PERIOD_MS 500
+  #define SENSOR_TASK_STACK 4096
+  #define SENSOR_TASK_PRIO 2    // Below the touch sampler
+  #define SENSOR_WIRE_TIMEOUT_MS 10 // Bus-wide; the touch reads are a few bytes
+  #define SENSOR_BACKOFF_MAX 16 // Cycles between probes at most, a power of two
+
+  struct Threshold
+  {
+      milli_t target_ph, target_ec;
+      bool PUMP;
+  };
+
+  struct SystemMeasurements
+  {
+      milli_t ph;
+      milli_t ec;
+      milli_t temp;
+      bool wl;
+  };
+
+  // I2C layouts shared with the controller, converted once per transfer
+  struct ThresholdPacket
+  {
+      double target_ph, target_ec;
+      bool PUMP;
+  };
+
+  struct SystemMeasurementsPacket
+  {
+      double ph;
+      double ec;
+      double temp;
+      bool wl;
+  };
+
+  class SensorLink {
+
+    public:
+      bool begin(BaseType_t core, const Threshold &threshold) {
+        m_threshold = threshold;
+        Wire.setTimeOut(SENSOR_WIRE_TIMEOUT_MS);
+        return xTaskCreatePinnedToCore(run, "sensors", SENSOR_TASK_STACK, this, SENSOR_TASK_PRIO, NULL, core) == pdPASS;
+      }
+
+      // GUI side: true if `measurements` got a frame it had not seen yet
+      bool poll(SystemMeasurements &measurements) {
+        uint32_t version = m_measurements.read(measurements);
+        bool fresh = version != m_seen;
+        m_seen = version;
+        return fresh;
+      }
+
+      // GUI side
+      void setThreshold(const Threshold &threshold) {
+        m_thresholds.publish(threshold);
+      }
+
+      uint32_t cycles() const {
+        return m_cycles;
+      }
+
+      uint32_t failures() const {
+        return m_failures;
+      }
+
+    private:
+      Snapshot<SystemMeasurements> m_measurements;
+      Snapshot<Threshold> m_thresholds;
+      uint32_t m_seen = 0; // GUI side
+
+      // Owned by the task
+      Threshold m_threshold;
+      SystemMeasurements m_current = {0, 0, 0, false};
+      volatile uint32_t m_cycles = 0;
+      volatile uint32_t m_failures = 0;
+      uint8_t m_misses = 0; // Probes in a row the controller did not answer
+      uint8_t m_skip = 0;   // Cycles left before the next probe
+
+      static void run(void *arg) {
+        SensorLink *self = (SensorLink *)arg;
+        TickType_t wake = xTaskGetTickCount();
+        for (;;) {
+          self->cycle();
+          vTaskDelayUntil(&wake, pdMS_TO_TICKS(SENSOR_PERIOD_MS));
+        }
+      }
+
+      void cycle() {
+        // Keeps the one from begin() until the GUI publishes
+        m_thresholds.read(m_threshold);
+
+        simulate();
+        // The bus is held per transaction, so the touch task gets it in between
+        if (m_skip > 0) {
+          m_skip--;
+        } else if (check()) {
+          read();
+          write();
+        }
+
+        m_measurements.publish(m_current);
+        m_cycles++;
+      }
+
+      // An absent controller is probed less and less often, down to once per
+      // SENSOR_BACKOFF_MAX cycles, and reported once until it answers again
+      bool check() {
+        uint8_t error;
+        {
+          I2CLock bus;
+          Wire.beginTransmission(SENSOR_ADDRESS);
+          error = Wire.endTransmission();
+        }
+        if (error == 0) {
+          if (m_misses > 0) {
+            LOG_INFO("I2C connection established with slave");
+          }
+          m_misses = 0;
+          return true;
+        }
+        if (m_misses == 0) {
+          LOG_WARN("Failed to establish I2C connection with slave");
+        }
+        if ((1 << m_misses) <= SENSOR_BACKOFF_MAX) {
+          m_misses++;
+        }
+        m_skip = (1 << (m_misses - 1)) - 1; // 0, 1, 3, 7, 15 cycles
+        m_failures++;
+        return false;
+      }
+
+      // A short packet is dropped rather than published
+      void read() {
+        SystemMeasurementsPacket packet;
+        bool ok;
+        {
+          I2CLock bus;
+          ok = Wire.requestFrom(SENSOR_ADDRESS, sizeof packet) == sizeof packet &&
+               Wire.readBytes((byte*) &packet, sizeof packet) == sizeof packet;
+        }
+        if (ok) {
+          m_current.ph = milli_from_double(packet.ph);
+          m_current.ec = milli_from_double(packet.ec);
+          m_current.temp = milli_from_double(packet.temp);
+          m_current.wl = packet.wl;
+
+          LOG_DEBUG("I2C read: ph %.2f ec %.2f temp %.2f wl %d", packet.ph, packet.ec, packet.temp, packet.wl);
+        }
+        else {
+          m_failures++;
+          LOG_WARN("I2C read: could not connect");
+        }
+      }
+
+      void write() {
+        ThresholdPacket packet = {
+          .target_ph = milli_to_double(m_threshold.target_ph),
+          .target_ec = milli_to_double(m_threshold.target_ec),
+          .PUMP = m_threshold.PUMP
+        };
+        I2CLock bus;
+        Wire.beginTransmission(SENSOR_ADDRESS);
+        Wire.write((uint8_t*)&packet, sizeof(packet));
+        Wire.endTransmission();
+      }
+
+      // Temporary test values, steps of 0.01
+      void simulate() {
+        SystemMeasurements &m = m_current;
+        m.ph = m.ph + (rand() % 2) * 10 - (rand() % 2) * 10;
+        if (m.ph > m_threshold.target_ph + MILLI(0.05) && m_threshold.PUMP){
+          m.ph = m.ph - (rand() % 3) * 10;
+        }
+        else if (m.ph < m_threshold.target_ph - MILLI(0.05) && m_threshold.PUMP){
+          m.ph = m.ph + (rand() % 3) * 10;
+        }
+
+        m.ec = m.ec - (rand() % 2) * 10;
+        if (m.ec < m_threshold.target_ec && m_threshold.PUMP){
+          m.ec = m.ec + (rand() % 4) * 10;
+        }
+        if (m.ec < 0){
+          m.ec = 0;
+        }
+
+        m.temp = MILLI(60) + (rand() % 500) * 10;
+
+        int wl_threshold = rand() % 100;
+        m.wl = false;
+        if (wl_threshold > 10){
+          m.wl = true;
+        }
+      }
+  };
+
+#endif
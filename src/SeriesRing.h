@@ -0,0 +1,80 @@
+/*
+ * Ring of samples over caller-provided storage, with O(1) append and logical indexing
+ */
+#ifndef _SeriesRing_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+  #define _SeriesRing_H_ 1
+
+  template <typename T>
+  class SeriesRing {
+
+    public:
+      SeriesRing() {
+      }
+
+      SeriesRing(T *storage, uint16_t capacity) {
+        attach(storage, capacity);
+      }
+
+      void attach(T *storage, uint16_t capacity) {
+        m_data = storage;
+        m_capacity = capacity;
+        clear();
+      }
+
+      void push(const T &value) {
+        m_data[m_head] = value;
+        if (++m_head == m_capacity) {
+          m_head = 0;
+        }
+        if (m_count < m_capacity) {
+          m_count++;
+        }
+      }
+
+      void clear() {
+        m_head = 0;
+        m_count = 0;
+      }
+
+      uint16_t size() const {
+        return m_count;
+      }
+
+      uint16_t capacity() const {
+        return m_capacity;
+      }
+
+      // Logical index, 0 is the oldest retained sample
+      const T &at(uint16_t i) const {
+        uint32_t slot = (uint32_t)m_head + (m_capacity - m_count) + i;
+        return m_data[slot >= m_capacity ? slot - m_capacity : slot];
+      }
+
+      // Sample `back` steps before the newest one
+      const T &fromNewest(uint16_t back) const {
+        return at(m_count - 1 - back);
+      }
+
+      /*
+       * Copy `count` samples, oldest first, ending `back` samples before the
+       * newest. Slots older than the retained history are set to `fill`.
+       */
+      void window(T *dst, uint16_t count, uint16_t back, const T &fill) const {
+        for (uint16_t i = 0; i < count; i++) {
+          uint32_t age = (uint32_t)back + count - 1 - i;
+          dst[i] = age < m_count ? fromNewest(age) : fill;
+        }
+      }
+
+    private:
+      T *m_data = NULL;
+      uint16_t m_capacity = 0;
+      uint16_t m_head = 0;
+      uint16_t m_count = 0;
+  };
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Latest-value publisher for one writer and any number of readers
+ *
+ * Two copies behind a sequence count (a seqlock latch): while the writer
+ * updates one copy, readers are pointed at the other, so a read only retries
+ * if a publish completed half of its work during the copy. A writer preempted
+ * mid-publish never holds readers up, and neither side takes a lock.
+ */
+#ifndef _Snapshot_H_
+
+#include <stdint.h>
+#include <atomic>
+
+  #define _Snapshot_H_ 1
+
+  template <typename T>
+  class Snapshot {
+
+    public:
+      // Writer side, one task only
+      void publish(const T &value) {
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+
+        // Readers to copy 1 while copy 0 is written
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_copy[0] = value;
+
+        // Readers to copy 0 while copy 1 is written
+        m_seq.store(seq + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_copy[1] = value;
+      }
+
+      // Copies the latest value into `value` and returns its version, the
+      // number of publishes so far. 0 means nothing was published yet and
+      // `value` is left alone.
+      uint32_t read(T &value) const {
+        for (;;) {
+          uint32_t seq = m_seq.load(std::memory_order_acquire);
+          if (seq < 2) {
+            return 0;
+          }
+          T copy = m_copy[seq & 1];
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (m_seq.load(std::memory_order_relaxed) == seq) {
+            value = copy;
+            return seq >> 1;
+          }
+        }
+      }
+
+      uint32_t version() const {
+        return m_seq.load(std::memory_order_acquire) >> 1;
+      }
+
+    private:
+      std::atomic<uint32_t> m_seq{0};
+      T m_copy[2];
+  };
+
+#endif
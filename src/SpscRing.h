@@ -0,0 +1,50 @@
+/*
+ * Lock-free ring for one producer and one consumer, which may run on different cores
+ */
+#ifndef _SpscRing_H_
+
+#include <stdint.h>
+#include <atomic>
+
+  #define _SpscRing_H_ 1
+
+  // N must be a power of two; indices run freely and wrap at 2^16
+  template <typename T, uint16_t N>
+  class SpscRing {
+
+    static_assert((N & (N - 1)) == 0 && N <= 32768, "SpscRing size must be a power of two");
+
+    public:
+      // Producer side. False if the ring is full, the value is not queued.
+      bool push(const T &value) {
+        uint16_t head = m_head.load(std::memory_order_relaxed);
+        if ((uint16_t)(head - m_tail.load(std::memory_order_acquire)) == N) {
+          return false;
+        }
+        m_data[head & (N - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+      }
+
+      // Consumer side
+      bool pop(T &value) {
+        uint16_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+          return false;
+        }
+        value = m_data[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+      }
+
+      bool empty() const {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+      }
+
+    private:
+      T m_data[N];
+      std::atomic<uint16_t> m_head{0};
+      std::atomic<uint16_t> m_tail{0};
+  };
+
+#endif
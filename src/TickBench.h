@@ -0,0 +1,116 @@
+/*
+ * One second of the GUI's measurement path in doubles and in milli-units
+ *
+ * A tick is what the readings, values and chart tasks did per second before
+ * the sensor task took the readings over: two random-walk readings, two
+ * rounds of value text and one chart sample. The double version is the code
+ * as it was before Fixed.h, kept only for "bench tick" and sim/bench/tick.cpp.
+ * Text goes into a buffer instead of a label so LVGL stays out of the figure.
+ */
+#ifndef _TickBench_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Fixed.h"
+#include "RollupStore.h"
+
+  #define _TickBench_H_ 1
+
+  #define TICK_BENCH_BUCKETS (ROLLUP_LEVELS * 24)
+
+  class TickBench {
+
+    public:
+      TickBench() : m_phRollup(m_phBuf, m_capacity), m_ecRollup(m_ecBuf, m_capacity) {
+      }
+
+      // Returns something of the work so it is not optimised away
+      uint32_t doubleTick() {
+        for (uint8_t i = 0; i < 2; i++) {
+          doubleReadings();
+          doubleValues();
+        }
+        return m_phRollup.add(lround(m_double.ph * 100)) + m_ecRollup.add(lround(m_double.ec * 100)) + m_text[0];
+      }
+
+      uint32_t fixedTick() {
+        for (uint8_t i = 0; i < 2; i++) {
+          fixedReadings();
+          fixedValues();
+        }
+        return m_phRollup.add(milli_round(m_fixed.ph, 2)) + m_ecRollup.add(milli_round(m_fixed.ec, 2)) + m_text[0];
+      }
+
+    private:
+      struct {
+        double ph, ec, temp, target_ph, target_ec;
+        bool wl, pump;
+      } m_double = {7, 1, 20, 6, 2, false, true};
+
+      struct {
+        milli_t ph, ec, temp, target_ph, target_ec;
+        bool wl, pump;
+      } m_fixed = {MILLI(7), MILLI(1), MILLI(20), MILLI(6), MILLI(2), false, true};
+
+      const uint16_t m_capacity[ROLLUP_LEVELS] = {24, 24, 24, 24, 24, 24, 24}; // Before the stores
+      Rollup m_phBuf[TICK_BENCH_BUCKETS];
+      Rollup m_ecBuf[TICK_BENCH_BUCKETS];
+      RollupStore m_phRollup;
+      RollupStore m_ecRollup;
+      char m_text[24];
+
+      void doubleReadings() {
+        m_double.ph = m_double.ph + ((double)(rand() % 2) / 100) - ((double)(rand() % 2) / 100);
+        if (m_double.ph > m_double.target_ph + 0.05 && m_double.pump) {
+          m_double.ph = m_double.ph - ((double)(rand() % 3) / 100);
+        } else if (m_double.ph < m_double.target_ph - 0.05 && m_double.pump) {
+          m_double.ph = m_double.ph + ((double)(rand() % 3) / 100);
+        }
+        m_double.ec = m_double.ec - ((double)(rand() % 2) / 100);
+        if (m_double.ec < m_double.target_ec && m_double.pump) {
+          m_double.ec = m_double.ec + ((double)(rand() % 4) / 100);
+        }
+        if (m_double.ec < 0) {
+          m_double.ec = 0;
+        }
+        m_double.temp = 60 + ((double)(rand() % 500) / 100);
+        m_double.wl = rand() % 100 > 10;
+      }
+
+      void fixedReadings() {
+        m_fixed.ph = m_fixed.ph + (rand() % 2) * 10 - (rand() % 2) * 10;
+        if (m_fixed.ph > m_fixed.target_ph + MILLI(0.05) && m_fixed.pump) {
+          m_fixed.ph = m_fixed.ph - (rand() % 3) * 10;
+        } else if (m_fixed.ph < m_fixed.target_ph - MILLI(0.05) && m_fixed.pump) {
+          m_fixed.ph = m_fixed.ph + (rand() % 3) * 10;
+        }
+        m_fixed.ec = m_fixed.ec - (rand() % 2) * 10;
+        if (m_fixed.ec < m_fixed.target_ec && m_fixed.pump) {
+          m_fixed.ec = m_fixed.ec + (rand() % 4) * 10;
+        }
+        if (m_fixed.ec < 0) {
+          m_fixed.ec = 0;
+        }
+        m_fixed.temp = MILLI(60) + (rand() % 500) * 10;
+        m_fixed.wl = rand() % 100 > 10;
+      }
+
+      void doubleValues() {
+        snprintf(m_text, sizeof m_text, "%.2f", m_double.ph);
+        snprintf(m_text, sizeof m_text, "%.2f mS/cm", m_double.ec);
+        snprintf(m_text, sizeof m_text, "%.1f", m_double.target_ph);
+        snprintf(m_text, sizeof m_text, "%.1f mS/cm", m_double.target_ec);
+        snprintf(m_text, sizeof m_text, "%.1f°C", m_double.temp);
+      }
+
+      void fixedValues() {
+        milli_format(m_text, sizeof m_text, m_fixed.ph, 2, "");
+        milli_format(m_text, sizeof m_text, m_fixed.ec, 2, " mS/cm");
+        milli_format(m_text, sizeof m_text, m_fixed.target_ph, 1, "");
+        milli_format(m_text, sizeof m_text, m_fixed.target_ec, 1, " mS/cm");
+        milli_format(m_text, sizeof m_text, m_fixed.temp, 1, "°C");
+      }
+  };
+
+#endif
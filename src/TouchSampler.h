@@ -0,0 +1,100 @@
+/*
+ * Fixed-rate touch sampling from its own task, handed to LVGL through a ring
+ *
+ * LVGL only reads input when its indev timer comes up inside lv_task_handler(),
+ * so a long render or the loop delay can swallow a short tap. The sampler
+ * task runs on the other core and timestamps every sample it queues.
+ */
+#ifndef _TouchSampler_H_
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "FT62XXTouchScreen.h"
+#include "SpscRing.h"
+
+  #define _TouchSampler_H_ 1
+
+  #define TOUCH_SAMPLE_MS 5    // 200 Hz, twice the FT6236 report rate
+  #define TOUCH_RING_SIZE 32   // 160 ms of held touch before samples drop
+  #define TOUCH_TASK_STACK 3072
+  #define TOUCH_TASK_PRIO 3
+
+  typedef struct TouchSample {
+    uint32_t us;  // micros() when sampled
+    uint16_t xPos;
+    uint16_t yPos;
+    bool touched;
+  } TouchSample;
+
+  class TouchSampler {
+
+    public:
+      TouchSampler(FT62XXTouchScreen &touch) : m_touch(touch) {
+      }
+
+      // Task to wake with a notification for every sample queued
+      void notify(TaskHandle_t task) {
+        m_notify = task;
+      }
+
+      bool begin(BaseType_t core) {
+        return xTaskCreatePinnedToCore(run, "touch", TOUCH_TASK_STACK, this, TOUCH_TASK_PRIO, NULL, core) == pdPASS;
+      }
+
+      // Consumer side, from the LVGL thread only
+      bool pop(TouchSample &sample) {
+        return m_ring.pop(sample);
+      }
+
+      bool pending() const {
+        return !m_ring.empty();
+      }
+
+      uint32_t samples() const {
+        return m_samples;
+      }
+
+      uint32_t dropped() const {
+        return m_dropped;
+      }
+
+    private:
+      FT62XXTouchScreen &m_touch;
+      SpscRing<TouchSample, TOUCH_RING_SIZE> m_ring;
+      TaskHandle_t m_notify = NULL;
+      bool m_down = false;
+      volatile uint32_t m_samples = 0;
+      volatile uint32_t m_dropped = 0;
+
+      static void run(void *arg) {
+        TouchSampler *self = (TouchSampler *)arg;
+        TickType_t wake = xTaskGetTickCount();
+        for (;;) {
+          self->sample();
+          vTaskDelayUntil(&wake, pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+        }
+      }
+
+      // Every sample while pressed plus the release; nothing while idle.
+      // A release that didn't fit is sent again on the next period.
+      void sample() {
+        uint32_t us = micros();
+        TouchPoint p = m_touch.read();
+        if (!p.touched && !m_down) {
+          return;
+        }
+        TouchSample s = {us, p.xPos, p.yPos, p.touched};
+        m_samples++;
+        if (m_ring.push(s)) {
+          m_down = p.touched;
+          if (m_notify != NULL) {
+            xTaskNotifyGive(m_notify);
+          }
+        } else {
+          m_dropped++;
+        }
+      }
+  };
+
+#endif
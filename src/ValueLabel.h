@@ -0,0 +1,55 @@
+/*
+ * Label bound to a fixed-point value: redrawn only when the displayed text changes
+ */
+#ifndef _ValueLabel_H_
+
+#include "lvgl.h"
+#include "Fixed.h"
+
+  #define _ValueLabel_H_ 1
+
+  class ValueLabel {
+
+    public:
+      void bind(lv_obj_t *label, uint8_t decimals, const char *suffix) {
+        m_label = label;
+        m_decimals = decimals;
+        m_suffix = suffix;
+        m_valid = false;
+      }
+
+      // Returns true if the label was updated (and invalidated)
+      bool set(milli_t value) {
+        int32_t shown = milli_round(value, m_decimals);
+        if (m_valid && shown == m_shown) {
+          return false;
+        }
+        m_shown = shown;
+        m_valid = true;
+        milli_format(m_text, sizeof m_text, value, m_decimals, m_suffix);
+        lv_label_set_text_static(m_label, m_text);
+        return true;
+      }
+
+      // For fixed strings such as status words; `text` must outlive the label
+      bool setText(const char *text) {
+        if (m_valid && text == m_static) {
+          return false;
+        }
+        m_static = text;
+        m_valid = true;
+        lv_label_set_text_static(m_label, text);
+        return true;
+      }
+
+    private:
+      lv_obj_t *m_label = NULL;
+      uint8_t m_decimals = 0;
+      const char *m_suffix = "";
+      const char *m_static = NULL;
+      int32_t m_shown = 0;
+      bool m_valid = false;
+      char m_text[16];
+  };
+
+#endif
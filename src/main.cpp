@@ -6,20 +6,67 @@
 #include <SPI.h>
 #include <TFT_eSPI.h> 
 #include "FT62XXTouchScreen.h"
+#include "TouchSampler.h"
+#include "FlushScheduler.h"
+#include "RollupStore.h"
+#include "Fixed.h"
+#include "ValueLabel.h"
+#include "ChromeCache.h"
+#include "Dashboard.h"
+#include "Log.h"
+#include "ScreenRouter.h"
+#include "SensorLink.h"
+#include "I2CBus.h"
 
 TFT_eSPI lcd = TFT_eSPI();
+I2CBus i2cBus;
 FT62XXTouchScreen touchScreen = FT62XXTouchScreen(TFT_WIDTH, PIN_SDA, PIN_SCL);
+TouchSampler touchSampler = TouchSampler(touchScreen);
+SensorLink sensorLink;
+FlushScheduler flushScheduler = FlushScheduler(lcd);
 
 #include "lvgl.h"
 #include "esp_freertos_hooks.h"
+#include "Profiler.h"
+#include "LatencyProbe.h"
+#if PROFILER
+#include "TickBench.h"
+#endif
+#if PROFILER && defined(ARDUINO_ARCH_ESP32)
+#include "CoreLoad.h"
+#endif
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
+Logger logger;
+#endif
+
+enum Screen {
+  SCREEN_SPLASH,
+  SCREEN_MAIN,
+  SCREEN_SETTINGS
+};
+
+ScreenRouter router;
 
-#define SLAVE_ADDRESS 0x08
+#if PROFILER
+Profiler profiler;
+LatencyProbe latencyProbe;
+static uint32_t first_frame_ms = 0; // Boot to the first complete frame on the panel
+static uint32_t loop_iterations = 0; // One lv_task_handler() call each
+static lv_task_t *prof_bin_task; // Off until "prof bin on"
+#endif
+#if PROFILER && defined(ARDUINO_ARCH_ESP32)
+CoreLoad coreLoad;
+static uint8_t core_busy[CORE_COUNT] = {0}; // Percent over the last second
+#endif
 
 static lv_disp_buf_t disp_buf;
-static lv_color_t buf[LV_HOR_RES_MAX * 10];
+static lv_color_t buf_1[LV_HOR_RES_MAX * 10]; // Two draw buffers: LVGL renders into one
+static lv_color_t buf_2[LV_HOR_RES_MAX * 10]; // while DMA sends the other to the panel
 
 lv_disp_drv_t disp_drv;
 lv_indev_drv_t indev_drv;
+lv_indev_t *touch_indev;
 
 // LVGL Objects
 lv_obj_t *settings;
@@ -28,9 +75,13 @@ lv_obj_t *ph_btn;
 lv_obj_t *ec_btn;
 lv_obj_t *settings_btn;
 lv_obj_t *refresh_btn;
+lv_obj_t *older_btn;
+lv_obj_t *newer_btn;
 lv_obj_t *settings_cls_btn;
 
 lv_obj_t *screen;
+lv_obj_t *screen_settings; // Built on first open, NULL while it doesn't exist
+lv_obj_t *splashscreen;
 lv_obj_t *body_main;
 lv_obj_t *splashscreen_main;
 lv_obj_t *body_settings;
@@ -64,6 +115,20 @@ lv_obj_t *EC_text_target_val;
 lv_obj_t *WL_text_val;
 lv_obj_t *temp_text_val;
 
+// Value bindings, formatted without printf and only redrawn on change
+#if DASHBOARD
+static Dashboard dashboard;
+typedef DashboardCell ValueBinding;
+#else
+typedef ValueLabel ValueBinding;
+#endif
+static ValueBinding ph_value;
+static ValueBinding ph_target_value;
+static ValueBinding ec_value;
+static ValueBinding ec_target_value;
+static ValueBinding wl_value;
+static ValueBinding temp_value;
+static uint32_t label_updates = 0; // Value labels redrawn, for the stats
 lv_obj_t *settings_text;
 lv_obj_t *settings_ph_text;
 lv_obj_t *settings_ec_text;
@@ -78,54 +143,50 @@ lv_obj_t *ecChart;
 lv_obj_t *splashscreen_img;
 LV_IMG_DECLARE(icon);
 
-// Values
-double total_ph = 0; // To take average value, or use in chart 
-double total_ec = 0; // (ie, if chart delay set to 10 mins, chart will update avg val of 10 mins)
-
-struct Threshold
-{
-    double target_ph, target_ec;
-    bool PUMP;
-};
-
-static Threshold THRESHOLD{.target_ph = 6.0, .target_ec = 2.0, .PUMP = false};
-
-struct SystemMeasurements
-{
-    double ph;
-    double ec;
-    double temp;
-    bool wl;
-};
-
-static SystemMeasurements system_measurements{.ph = 0.0, .ec = 0.0, .temp = 0.0, .wl = false};
+// GUI side copies, exchanged with the sensor task through sensorLink
+static Threshold THRESHOLD{.target_ph = MILLI(6.0), .target_ec = MILLI(2.0), .PUMP = false};
+static SystemMeasurements system_measurements{.ph = 0, .ec = 0, .temp = 0, .wl = false};
 
 // Chart Y value
 int ph_max = 8;
 int ph_min = 4;
 int ec_max = 4;
 int ec_min = 0;
-int points = 24; // Chart point amount
+const int points = 24; // Chart point amount
 
 // Chart Delay Option
-int delay_option = 0; // Delay option
-int delay_ms = 1000; // Chart delay in ms
-int delay_current = 0; // Current delay count
-
-// Status
-bool settings_btn_pressed = false;
-bool settings_cls_btn_pressed = false;
-int spl_scrn = 0;
+int delay_option = 0; // Delay option, also the rollup level shown on the charts
+uint16_t chart_back = 0; // Buckets between the newest and the right edge of the charts, 0 is live
 
 // Chart Object
 lv_chart_series_t * ph_ser;
 lv_chart_series_t * ec_ser;
 
+// Chart rollups in hundredths, one level per delay option (1 s ... 2 h).
+// Every level keeps a chart's worth of buckets, the 1 minute level a full day
+// that the older/newer buttons page through.
+#define ROLLUP_BUCKETS (6 * 24 + 1440)
+static const uint16_t rollup_capacity[ROLLUP_LEVELS] = {24, 24, 1440, 24, 24, 24, 24};
+static Rollup ph_rollup_buf[ROLLUP_BUCKETS];
+static Rollup ec_rollup_buf[ROLLUP_BUCKETS];
+static RollupStore ph_rollup(ph_rollup_buf, rollup_capacity);
+static RollupStore ec_rollup(ec_rollup_buf, rollup_capacity);
+
 // Style Object
 static lv_style_t screen_st;
 static lv_style_t body_st;
 static lv_style_t setting_st;
 static lv_style_t tab_st;
+// Shared by every label and chart instead of per-object local styles
+static lv_style_t text_st;
+static lv_style_t chart_bg_st;
+static lv_style_t chart_div_st;
+static lv_style_t chart_series_st;
+static lv_style_t btn_plus_st;
+static lv_style_t btn_minus_st;
+
+// Free LVGL heap below which the settings screen is dropped on close
+#define SETTINGS_KEEP_FREE (8 * 1024U)
 
 // Brightness Settings
 static const uint8_t backlightChannel = 1;
@@ -135,31 +196,41 @@ uint32_t currentBrightness = 96;
 void disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
 bool input_read(lv_indev_drv_t * drv, lv_indev_data_t*data) ;
 
-void update_chart_val(int val, lv_chart_series_t *ser);
+static void load_chart_level(lv_chart_series_t *ser, const RollupStore &rollup, lv_coord_t empty);
+static void invalidate_chart_series(lv_obj_t *chart);
+static uint16_t chart_back_max();
+static void reload_charts();
 
 // Task Function
-void task_update_settings_button_status(lv_task_t *task);
-void task_update_settings_cls_button_status(lv_task_t *task);
-static void task_check_I2C(lv_task_t *task);
-static void task_read_I2C(lv_task_t *task);
-static void task_write_I2C(lv_task_t *task);
 static void task_update_chart(lv_task_t *task);
 static void task_update_values(lv_task_t *task) ;
-static void task_rand_value_readings(lv_task_t *task);
 static void task_update_brightness(lv_task_t *task);
 static void lv_tick_task(void);
+#if PROFILER
+static void report_screen_heap(const char *name);
+static void task_profiler_dump(lv_task_t *task);
+static void task_serial_commands(lv_task_t *task);
+static void task_rates(lv_task_t *task);
+#endif
 
 //Style Function
 static void build_style_mainscreen();
 
 // Build Function
+#if !DASHBOARD
 static void build_text_mainscreen();
+#endif
 static void build_screen();
 static void build_text_settings();
 static void build_chart_mainscreen();
 static void build_body_mainscreen();
 static void build_buttons_mainscreen();
 static void build_widgets_mainscreen();
+#if DASHBOARD
+static void build_dashboard_mainscreen();
+#else
+static void build_chrome_cache_mainscreen();
+#endif
 static void build_buttons_settings();
 static void build_body_settings();
 static void build_body_splashscreen();
@@ -178,8 +249,18 @@ static void dropdown_change_delay_event(lv_obj_t * obj, lv_event_t event);
 static void button_ph_change_chart_event(lv_obj_t * btn, lv_event_t e);
 static void button_ec_change_chart_event(lv_obj_t * btn, lv_event_t e);
 static void button_chart_refresh_event(lv_obj_t * btn, lv_event_t e);
-
-static void task_splash_screen(lv_task_t *task);
+static void button_chart_older_event(lv_obj_t * btn, lv_event_t e);
+static void button_chart_newer_event(lv_obj_t * btn, lv_event_t e);
+
+// Navigation Function
+static lv_obj_t *enter_splash();
+static void leave_splash(lv_obj_t *scr);
+static lv_obj_t *enter_main();
+static lv_obj_t *enter_settings();
+static void leave_settings(lv_obj_t *scr);
+#if PROFILER
+static void screen_changed(uint8_t from, uint8_t to);
+#endif
 
 //Widget Function
 static void build_widgets_settings();
@@ -191,92 +272,134 @@ void setup() {
   initialize();
   lv_png_init();
 
-  build_screen();
   build_style_mainscreen();
 
+  router.add(SCREEN_SPLASH, "splash", enter_splash, leave_splash);
+  router.add(SCREEN_MAIN, "main", enter_main);
+  router.add(SCREEN_SETTINGS, "settings", enter_settings, leave_settings);
+#if PROFILER
+  router.onTransition(screen_changed);
+#endif
+
+  // Splashscreen goes out first and stays up while the rest is built
+  router.go(SCREEN_SPLASH);
+  lv_refr_now(NULL);
+
   // Build order: Style -> Body -> Buttons -> Text -> Others
 
   // Mainscreen
+  build_screen();
   build_body_mainscreen();
   build_buttons_mainscreen();
+#if !DASHBOARD
   build_text_mainscreen();
+#endif
   build_chart_mainscreen();
   build_widgets_mainscreen();
+#if DASHBOARD
+  build_dashboard_mainscreen();
+#elif CHROME_CACHE
+  build_chrome_cache_mainscreen();
+#endif
 
-  // Settings
-  build_body_settings();
-  build_buttons_settings();
-  build_text_settings();
-  build_widgets_settings();
-
-  //Splashscreen
-  build_body_splashscreen();
+  // Settings are built on first open, see enter_settings()
 
   // Tasks
-  lv_task_create(task_rand_value_readings, 500, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_update_chart, 1000, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_update_values, 500, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_update_brightness, 100, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_check_I2C, 500, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_read_I2C, 500, LV_TASK_PRIO_MID, NULL);
-  lv_task_create(task_write_I2C, 500, LV_TASK_PRIO_MID, NULL);
-  
-  lv_task_t * splash_screen = lv_task_create(task_splash_screen, 3000, LV_TASK_PRIO_MID, NULL);
-  lv_task_set_repeat_count(splash_screen, 1);
-  lv_task_create(task_update_settings_button_status, 10, LV_TASK_PRIO_HIGH, NULL);
-  lv_task_create(task_update_settings_cls_button_status, 10, LV_TASK_PRIO_HIGH, NULL);
+  PROF_TASK(lv_task_create(task_update_chart, 1000, LV_TASK_PRIO_MID, NULL), "chart");
+  PROF_TASK(lv_task_create(task_update_values, 500, LV_TASK_PRIO_MID, NULL), "values");
+  PROF_TASK(lv_task_create(task_update_brightness, 100, LV_TASK_PRIO_MID, NULL), "brightness");
+  PROF_TASK(router.goAfter(SCREEN_MAIN, 3000), "splash");
 
-  // Screen load
-  lv_scr_load(screen);
+#if PROFILER
+  prof_bin_task = lv_task_create(task_profiler_dump, PROF_DUMP_PERIOD, LV_TASK_PRIO_OFF, NULL);
+  lv_task_create(task_serial_commands, 100, LV_TASK_PRIO_LOW, NULL);
+  lv_task_create(task_rates, 1000, LV_TASK_PRIO_LOW, NULL);
+#endif
 
 }
 
 void loop() {
 
-  lv_task_handler();
-  delay(5);
+#if PROFILER
+  // Iteration to iteration, so the jitter of everything in the loop shows
+  static uint32_t last_iteration = 0;
+  uint32_t now = micros();
+  loop_iterations++;
+  if (last_iteration != 0) {
+    profiler.recordUs(PROF_GAP, now - last_iteration);
+  }
+  last_iteration = now;
+#endif
+  uint32_t next;
+  {
+    PROF_SCOPE(PROF_LOOP);
+    next = lv_task_handler();
+  }
+
+  // Sleep until the next lv_task is due, or until the touch task queues a
+  // sample: then LVGL reads input right away instead of on its next period
+  if (ulTaskNotifyTake(pdTRUE, next == LV_NO_TASK_READY ? portMAX_DELAY : pdMS_TO_TICKS(next)) > 0) {
+    lv_task_ready(touch_indev->driver.read_task);
+  }
 
 }
 
 void disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
-    uint32_t w = (area->x2 - area->x1 + 1);
-    uint32_t h = (area->y2 - area->y1 + 1);
-
-    lcd.startWrite();
-    lcd.setAddrWindow(area->x1, area->y1, w, h);
-    lcd.pushColors((uint16_t *)&color_p->full, w * h, true);
-    lcd.endWrite();
+    PROF_SCOPE(PROF_FLUSH);
+    flushScheduler.push(area, (uint16_t *)&color_p->full, lv_disp_flush_is_last(disp));
+
+#if PROFILER
+    // Only on the photon flush: lets the probe stop when the pixels are out
+    if (latencyProbe.covers(area)) {
+      lcd.dmaWait();
+      latencyProbe.landed();
+    }
+    if (first_frame_ms == 0 && lv_disp_flush_is_last(disp)) {
+      first_frame_ms = millis();
+    }
+#endif
 
+    // The area is owned by DMA now. LVGL renders the next one into the other
+    // buffer, and the scheduler waits for this one before it is reused.
     lv_disp_flush_ready(disp);
 }
 
 uint16_t lastx = 0;
 uint16_t lasty = 0;
+bool touch_pressed = false;
+#if PROFILER
+static uint32_t touch_presses = 0; // Presses LVGL was given, to compare with the taps made
+#endif
 
+// One buffered sample per call; returning true makes LVGL read again right away
 bool input_read(lv_indev_drv_t * drv, lv_indev_data_t*data) {
-  Serial.println("#");
-  TouchPoint touchPos = touchScreen.read();
-  if (touchPos.touched) {
-    Serial.println(String(touchPos.xPos) + ": " + String(touchPos.yPos));
-    data->state = LV_INDEV_STATE_PR;
-    data->point.x = touchPos.xPos;
-    data->point.y = touchPos.yPos;
-    lastx = touchPos.xPos;
-    lasty = touchPos.yPos;
-  } else {
-    data->state = LV_INDEV_STATE_REL;
-     data->point.x = lastx;
-     data->point.y = lasty;
-     
+  PROF_SCOPE(PROF_INPUT);
+  LOG_TRACE("input read");
+  TouchSample sample;
+  if (touchSampler.pop(sample)) {
+#if PROFILER
+    profiler.recordUs(PROF_TOUCH, micros() - sample.us);
+    latencyProbe.touch(sample.us);
+    touch_presses += sample.touched && !touch_pressed;
+#endif
+    touch_pressed = sample.touched;
+    if (sample.touched) {
+      LOG_DEBUG("touch %u,%u", sample.xPos, sample.yPos);
+      lastx = sample.xPos;
+      lasty = sample.yPos;
+    }
   }
-  return false;
+  data->state = touch_pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+  data->point.x = lastx;
+  data->point.y = lasty;
+  return touchSampler.pending();
 }
 
 void create_text(lv_obj_t *text, int posx, int posy, const char *word){
   lv_obj_set_size(text, 64, 16);
   lv_obj_set_pos(text, posx, posy);
-  lv_obj_set_style_local_text_color(text, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_WHITE);
+  lv_obj_add_style(text, LV_LABEL_PART_MAIN, &text_st);
   lv_label_set_text(text, word);
   lv_label_set_align(text, LV_LABEL_ALIGN_CENTER);
 }
@@ -284,152 +407,445 @@ void create_text(lv_obj_t *text, int posx, int posy, const char *word){
 void create_val_text(lv_obj_t *text, lv_obj_t *body, int posx, int posy){
   lv_obj_set_size(text, 64, 16);
   lv_obj_set_pos(text, posx, posy);
-  lv_obj_set_style_local_text_color(text, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_WHITE);
+  lv_obj_add_style(text, LV_LABEL_PART_MAIN, &text_st);
   lv_label_set_align(text, LV_LABEL_ALIGN_CENTER);
 }
 
-void update_chart_val(int val, lv_chart_series_t *ser){
-  for(int i=0; i<points-1; i++){
-    ser->points[i] = ser->points[i+1];
+// Fill the chart from the rollup level of the current delay option, oldest bucket
+// on the left. Live, the charts are circular and the next bucket goes after the
+// newest. Paged back, they show the window ending chart_back buckets ago.
+static void load_chart_level(lv_chart_series_t *ser, const RollupStore &rollup, lv_coord_t empty){
+  const SeriesRing<Rollup> &level = rollup.level(delay_option);
+  const Rollup none = {0, 0, 0, 0};
+  Rollup slice[points];
+  int count = points;
+  if(chart_back == 0 && level.size() < points){
+    count = level.size();
   }
-  ser->points[points-1] = val;
-  
-}
-
-void task_check_I2C(lv_task_t *task){
-  Wire.beginTransmission(SLAVE_ADDRESS);  // Set the slave address to 0x50
-  if (Wire.endTransmission() == 0) {
-    Serial.println("I2C connection established with slave!");
-  } else {
-    Serial.println("Failed to establish I2C connection with slave.");
+  level.window(slice, count, chart_back, none);
+  for(int i=0; i<points; i++){
+    ser->points[i] = i < count && slice[i].count ? RollupStore::mean(slice[i]) / 10 : empty;
   }
+  ser->start_point = count % points;
 }
 
-void task_read_I2C(lv_task_t *task){
-  if (Wire.requestFrom(SLAVE_ADDRESS, sizeof system_measurements)) {
-    Wire.readBytes((byte*) &system_measurements, sizeof system_measurements);
+// Furthest back the charts can page while still showing a full window
+static uint16_t chart_back_max(){
+  uint16_t size = ph_rollup.level(delay_option).size();
+  return size > points ? size - points : 0;
+}
 
-    Serial.println("I2C Read:");
-    Serial.println(system_measurements.ph);
-    Serial.println(system_measurements.ec);
-    Serial.println(system_measurements.temp);
-    Serial.println(system_measurements.wl);
-  } 
-  else {
-    Serial.println("could not connect");
-  }
+static void reload_charts(){
+  load_chart_level(ph_ser, ph_rollup, ph_min * 10);
+  load_chart_level(ec_ser, ec_rollup, ec_min);
+  invalidate_chart_series(phChart);
+  invalidate_chart_series(ecChart);
 }
 
-void task_write_I2C(lv_task_t *task){
-  Wire.beginTransmission(SLAVE_ADDRESS);
-  Wire.write((uint8_t*)&THRESHOLD, sizeof(THRESHOLD));
-  Wire.endTransmission();
+// Redraw the whole plot area; the y axis labels in the left padding never change
+static void invalidate_chart_series(lv_obj_t *chart){
+  lv_area_t area;
+  lv_obj_get_coords(chart, &area);
+  area.x1 += lv_obj_get_style_pad_left(chart, LV_CHART_PART_BG);
+  lv_obj_invalidate_area(chart, &area);
 }
 
-void task_update_settings_button_status(lv_task_t *task){
-  lv_btn_state_t st = lv_btn_get_state(settings_btn);
-  if (st == LV_BTN_STATE_PRESSED){
-    settings_btn_pressed = true;
-  }
-  else if (st == LV_BTN_STATE_RELEASED && settings_btn_pressed){
-    lv_obj_set_pos(body_main, -4, -(lcd.height() + 8) - 4);
-    lv_obj_set_pos(body_settings, -4, -4);
-    settings_btn_pressed = false;
-  }
+static lv_obj_t *enter_splash(){
+  build_body_splashscreen();
+  return splashscreen;
 }
 
-void task_splash_screen(lv_task_t *task){
+static void leave_splash(lv_obj_t *scr){
+  lv_obj_del(splashscreen);
+  splashscreen = NULL;
+}
 
-  lv_obj_del(splashscreen_main);
+static lv_obj_t *enter_main(){
+  return screen;
 }
 
-void task_splashscreen(lv_task_t *task){
-  lv_btn_state_t st = lv_btn_get_state(settings_btn);
-  if (st == LV_BTN_STATE_PRESSED){
-    settings_btn_pressed = true;
+static lv_obj_t *enter_settings(){
+  if (screen_settings == NULL){
+    build_body_settings();
+    build_buttons_settings();
+    build_text_settings();
+    build_widgets_settings();
   }
-  else if (st == LV_BTN_STATE_RELEASED && settings_btn_pressed){
-    lv_obj_set_pos(body_main, -4, -(lcd.height() + 8) - 4);
-    lv_obj_set_pos(body_settings, -4, -4);
-    settings_btn_pressed = false;
+  return screen_settings;
+}
+
+// Short on LVGL heap: drop the settings screen, it is rebuilt from the current values on next open
+static void leave_settings(lv_obj_t *scr){
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  if (mon.free_size < SETTINGS_KEEP_FREE){
+    lv_obj_del_async(screen_settings);
+    // Everything below went with the screen
+    screen_settings = NULL;
+    body_settings = NULL;
+    tabBody_st = NULL;
+    settingsParam_ph = NULL;
+    settingsParam_ec = NULL;
+    settingsParam_delay = NULL;
+    settingsParam_brightness = NULL;
+    settings_cls_btn = NULL;
+    settings_text = NULL;
+    settings_ph_text = NULL;
+    settings_ec_text = NULL;
+    settings_delay_text = NULL;
+    settings_brightness_text = NULL;
+    spinbox_ph = NULL;
+    spinbox_ec = NULL;
+    slider_brightness = NULL;
   }
 }
 
-void task_update_settings_cls_button_status(lv_task_t *task){
-  lv_btn_state_t st = lv_btn_get_state(settings_cls_btn);
-  if (st == LV_BTN_STATE_PRESSED){
-    settings_cls_btn_pressed = true;
+static void task_update_chart(lv_task_t *task){
+
+  // One sample a second feeds every chart interval at once
+  uint8_t completed = ph_rollup.add(milli_round(system_measurements.ph, 2));
+  ec_rollup.add(milli_round(system_measurements.ec, 2));
+
+  if((completed & (1 << delay_option)) && chart_back > 0){
+
+    // Paged back: keep the same buckets on screen while new ones arrive,
+    // until the oldest of them leaves the level
+    if(chart_back < chart_back_max()){
+      chart_back++;
+    }
+    else {
+      reload_charts();
+    }
   }
-  else if (st == LV_BTN_STATE_RELEASED && settings_cls_btn_pressed){
-    lv_obj_set_pos(body_main, -4, -4);
-    lv_obj_set_pos(body_settings, -4, -(lcd.height() + 8) - 4);
-    settings_cls_btn_pressed = false;
+  else if(completed & (1 << delay_option)){
+
+    // Circular update: overwrites the oldest point and redraws only its
+    // column, or the line segments either side of it
+    const SeriesRing<Rollup> &ph_level = ph_rollup.level(delay_option);
+    const SeriesRing<Rollup> &ec_level = ec_rollup.level(delay_option);
+    lv_chart_set_next(phChart, ph_ser, RollupStore::mean(ph_level.fromNewest(0)) / 10);
+    lv_chart_set_next(ecChart, ec_ser, RollupStore::mean(ec_level.fromNewest(0)) / 10);
   }
+}
+
+static void task_update_values(lv_task_t *task) {
+
+  sensorLink.poll(system_measurements);
+  label_updates += ph_value.set(system_measurements.ph);
+  label_updates += ec_value.set(system_measurements.ec);
+  label_updates += ph_target_value.set(THRESHOLD.target_ph);
+  label_updates += ec_target_value.set(THRESHOLD.target_ec);
+  label_updates += temp_value.set(system_measurements.temp);
+  label_updates += wl_value.setText(system_measurements.wl ? "OK" : "LOW");
   
 }
 
-static void task_update_chart(lv_task_t *task){
+static void task_update_brightness(lv_task_t *task) {
+
+  ledcWrite(backlightChannel, currentBrightness);
+}
+
+#if PROFILER
+static void task_profiler_dump(lv_task_t *task) {
 
-  delay_current += 1000;
-  total_ph += system_measurements.ph;
-  total_ec += system_measurements.ec;
+  profiler.writeBinary();
+}
 
-  if(delay_current >= delay_ms){
+// Average time to redraw and flush one area, as after a value change
+static void bench_redraw(const char *name, const lv_area_t *area) {
+  const uint16_t runs = 100;
 
-    update_chart_val(total_ph / delay_ms * 10000, ph_ser);
-    update_chart_val(total_ec / delay_ms * 10000, ec_ser);
+  uint32_t start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    _lv_inv_area(NULL, area);
+    lv_refr_now(NULL);
+  }
+  uint32_t us = prof_ticks_to_us(prof_ticks() - start);
 
-    total_ph = 0;
-    total_ec = 0;
+  Serial.print("redraw ");
+  Serial.print(name);
+  Serial.print(" ");
+  Serial.print(us / runs);
+  Serial.println(" us");
+}
 
-    delay_current = 0;
+// Resolve the properties a redraw reads for every object of the active screen
+static uint16_t resolve_styles(lv_obj_t *obj) {
+  uint16_t objects = 1;
+  volatile uint32_t sink = 0;
+  sink += lv_obj_get_style_bg_opa(obj, LV_OBJ_PART_MAIN);
+  sink += lv_obj_get_style_bg_color(obj, LV_OBJ_PART_MAIN).full;
+  sink += lv_obj_get_style_border_opa(obj, LV_OBJ_PART_MAIN);
+  sink += lv_obj_get_style_pad_left(obj, LV_OBJ_PART_MAIN);
+  sink += lv_obj_get_style_text_color(obj, LV_OBJ_PART_MAIN).full;
+
+  lv_obj_t *child = lv_obj_get_child(obj, NULL);
+  while (child) {
+    objects += resolve_styles(child);
+    child = lv_obj_get_child(obj, child);
   }
-  lv_chart_refresh(phChart);
-  lv_chart_refresh(ecChart);
+  return objects;
 }
 
-static void task_update_values(lv_task_t *task) {
+static void bench_styles() {
+  const uint16_t runs = 100;
+  uint16_t objects = 0;
 
-  lv_label_set_text_fmt(pH_text_val, "%.2f" , system_measurements.ph);
-  lv_label_set_text_fmt(EC_text_val, "%.2f mS/cm" , system_measurements.ec);
-  lv_label_set_text_fmt(pH_text_target_val, "%.1f" , THRESHOLD.target_ph);
-  lv_label_set_text_fmt(EC_text_target_val, "%.1f mS/cm" , THRESHOLD.target_ec);
-  lv_label_set_text_fmt(temp_text_val, "%.1f°C" , system_measurements.temp);
-  lv_label_set_text(WL_text_val, (system_measurements.wl ? "OK" : "LOW"));
-  
+  uint32_t start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    objects = resolve_styles(lv_scr_act());
+  }
+  uint32_t us = prof_ticks_to_us(prof_ticks() - start);
+
+  Serial.print("style resolve ");
+  Serial.print(us / runs);
+  Serial.print(" us for ");
+  Serial.print(objects);
+  Serial.println(" objects");
+  report_screen_heap("active");
+}
+
+static void report_screen_heap(const char *name) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  Serial.print("screen ");
+  Serial.print(name);
+  Serial.print(", LVGL heap used ");
+  Serial.println((unsigned long)(mon.total_size - mon.free_size));
+}
+
+static void screen_changed(uint8_t from, uint8_t to) {
+  report_screen_heap(router.name(to));
 }
 
-static void task_rand_value_readings(lv_task_t *task) {
-  // Temporary test values
-  system_measurements.ph = system_measurements.ph + ((double)(rand() % 2) / 100) - ((double)(rand() % 2) / 100);
-  if (system_measurements.ph > THRESHOLD.target_ph + 0.05 && THRESHOLD.PUMP){
-    system_measurements.ph = system_measurements.ph - ((double)(rand() % 3) / 100);
+static uint32_t flush_pixels_per_s = 0;
+static uint32_t label_updates_per_min = 0;
+static uint32_t handler_calls_per_s = 0;
+static uint32_t task_runs_per_s = 0;
+
+static void task_rates(lv_task_t *task) {
+  static uint8_t seconds = 0;
+  static uint32_t label_updates_mark = 0;
+  static uint32_t loop_mark = 0;
+  static uint32_t task_runs_mark = 0;
+
+  flush_pixels_per_s = flushScheduler.takePixels();
+  handler_calls_per_s = loop_iterations - loop_mark;
+  loop_mark = loop_iterations;
+  task_runs_per_s = profiler.taskRuns() - task_runs_mark;
+  task_runs_mark = profiler.taskRuns();
+#ifdef ARDUINO_ARCH_ESP32
+  coreLoad.sample(core_busy);
+#endif
+  if (++seconds == 60) {
+    label_updates_per_min = label_updates - label_updates_mark;
+    label_updates_mark = label_updates;
+    seconds = 0;
   }
-  else if (system_measurements.ph < THRESHOLD.target_ph - 0.05 && THRESHOLD.PUMP){
-    system_measurements.ph = system_measurements.ph + ((double)(rand() % 3) / 100);
+}
+
+// Value label formatting, milli_format against newlib's float printf
+static void bench_formatter() {
+  const uint16_t runs = 10000;
+  char text[16];
+  volatile uint8_t sink = 0;
+
+  uint32_t start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    sink += milli_format(text, sizeof text, (milli_t)i * 7, 2, " mS/cm");
   }
+  uint32_t fixed_us = prof_ticks_to_us(prof_ticks() - start);
 
-  system_measurements.ec = system_measurements.ec - ((double)(rand() % 2) / 100);
-  if (system_measurements.ec < THRESHOLD.target_ec && THRESHOLD.PUMP){
-    system_measurements.ec = system_measurements.ec + ((double)(rand() % 4) / 100);
+  start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    sink += snprintf(text, sizeof text, "%.2f mS/cm", i * 0.007);
   }
-  if (system_measurements.ec < 0){
-    system_measurements.ec = 0;
+  uint32_t printf_us = prof_ticks_to_us(prof_ticks() - start);
+
+  Serial.print("milli_format ");
+  Serial.print(fixed_us);
+  Serial.print(" us, snprintf ");
+  Serial.print(printf_us);
+  Serial.print(" us for ");
+  Serial.println(runs);
+}
+
+// One second of the measurement path in doubles and in milli-units, see TickBench.h
+static void bench_tick() {
+  const uint16_t runs = 1000;
+  static TickBench bench;
+  volatile uint32_t sink = 0;
+
+  uint32_t start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    sink += bench.doubleTick();
   }
+  uint32_t double_ticks = prof_ticks() - start;
 
-  system_measurements.temp = 60 + ((double)(rand() % 500) / 100);
-  
-  double wl_threshold = rand() % 100;
-  system_measurements.wl = false;
-  if (wl_threshold > 10){
-    system_measurements.wl = true;
+  start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    sink += bench.fixedTick();
   }
+  uint32_t fixed_ticks = prof_ticks() - start;
+
+#ifdef ARDUINO_ARCH_ESP32
+  Serial.print("cycles per tick: double ");
+#else
+  Serial.print("ns per tick: double ");
+#endif
+  Serial.print(double_ticks / runs);
+  Serial.print(", fixed ");
+  Serial.println(fixed_ticks / runs);
 }
 
-static void task_update_brightness(lv_task_t *task) {
+// Snapshot read against a plain copy of the same struct
+static void bench_snapshot() {
+  const uint16_t runs = 10000;
+  static Snapshot<SystemMeasurements> snapshot;
+  static SystemMeasurements plain = {MILLI(6.5), MILLI(1.2), MILLI(21), true};
+  SystemMeasurements *volatile source = &plain; // Reloaded every time round
+  SystemMeasurements copy;
+  volatile uint32_t sink = 0;
+  snapshot.publish(plain);
+
+  uint32_t start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    sink += snapshot.read(copy);
+  }
+  uint32_t snapshot_us = prof_ticks_to_us(prof_ticks() - start);
 
-  ledcWrite(backlightChannel, currentBrightness);
+  start = prof_ticks();
+  for (uint16_t i = 0; i < runs; i++) {
+    copy = *source;
+    sink += copy.wl;
+  }
+  uint32_t plain_us = prof_ticks_to_us(prof_ticks() - start);
+
+  Serial.print("snapshot read ");
+  Serial.print(snapshot_us);
+  Serial.print(" us, plain copy ");
+  Serial.print(plain_us);
+  Serial.print(" us for ");
+  Serial.println(runs);
+}
+
+static void print_flush_stats(const char *label, const FlushStats &stats) {
+  Serial.print(label);
+  Serial.print(": ");
+  Serial.print(stats.areas);
+  Serial.print(" areas in ");
+  Serial.print(stats.transactions);
+  Serial.print(" windows, ");
+  Serial.print(stats.bytes);
+  Serial.println(" bytes");
+}
+
+// Line commands on Serial: "prof" prints the histograms, "prof bin" sends them
+// as one binary frame, "prof bin on [ms]" every PROF_DUMP_PERIOD or ms until
+// "prof bin off", "tasks" the lv_task costs, "prof reset" clears both
+static void task_serial_commands(lv_task_t *task) {
+  static char line[32];
+  static uint8_t len = 0;
+
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (len < sizeof line - 1) {
+        line[len++] = c;
+      }
+      continue;
+    }
+    line[len] = 0;
+    len = 0;
+
+    if (strcmp(line, "prof") == 0) {
+      profiler.printReport();
+      Serial.print("flush px/s ");
+      Serial.println(flush_pixels_per_s);
+      print_flush_stats("flush last frame", flushScheduler.lastFrame());
+      print_flush_stats("flush total", flushScheduler.total());
+      Serial.print("label updates/min ");
+      Serial.println(label_updates_per_min);
+      Serial.print("lv_task_handler calls/s ");
+      Serial.print(handler_calls_per_s);
+      Serial.print(", tracked task runs/s ");
+      Serial.print(task_runs_per_s);
+      Serial.print(", LVGL idle % ");
+      Serial.println(lv_task_get_idle());
+#ifdef ARDUINO_ARCH_ESP32
+      Serial.print("core busy % 0: ");
+      Serial.print(core_busy[0]);
+      Serial.print(", 1: ");
+      Serial.println(core_busy[1]);
+#endif
+      Serial.print("sensor cycles ");
+      Serial.print(sensorLink.cycles());
+      Serial.print(", failed reads ");
+      Serial.println(sensorLink.failures());
+      Serial.print("first frame ms ");
+      Serial.println(first_frame_ms);
+      Serial.print("touch samples ");
+      Serial.print(touchSampler.samples());
+      Serial.print(", dropped ");
+      Serial.print(touchSampler.dropped());
+      Serial.print(", presses ");
+      Serial.println(touch_presses);
+      Serial.print("photon probes ");
+      Serial.print(latencyProbe.probes());
+      Serial.print(", superseded ");
+      Serial.print(latencyProbe.superseded());
+      Serial.print(", timed out ");
+      Serial.println(latencyProbe.timedOut());
+#if LOG_LEVEL > LOG_LEVEL_NONE
+      Serial.print("log dropped ");
+      Serial.println(logger.dropped());
+#endif
+    }
+    else if (strcmp(line, "prof bin") == 0) {
+      profiler.writeBinary();
+    }
+    else if (strncmp(line, "prof bin on", 11) == 0) {
+      uint32_t period = strtoul(line + 11, NULL, 10);
+      lv_task_set_period(prof_bin_task, period ? period : PROF_DUMP_PERIOD);
+      lv_task_set_prio(prof_bin_task, LV_TASK_PRIO_LOW);
+    }
+    else if (strcmp(line, "prof bin off") == 0) {
+      lv_task_set_prio(prof_bin_task, LV_TASK_PRIO_OFF);
+    }
+    else if (strcmp(line, "tasks") == 0) {
+      profiler.printTasks();
+    }
+    else if (strcmp(line, "bench fmt") == 0) {
+      bench_formatter();
+    }
+    else if (strcmp(line, "bench tick") == 0) {
+      bench_tick();
+    }
+    else if (strcmp(line, "bench snapshot") == 0) {
+      bench_snapshot();
+    }
+    else if (strcmp(line, "bench redraw") == 0) {
+      lv_area_t value;
+      lv_area_t caption;
+#if DASHBOARD
+      ph_value.valueArea(&value);
+      ph_value.captionArea(&caption);
+#else
+      lv_obj_get_coords(pH_text_val, &value);
+      lv_obj_get_coords(pH_text, &caption);
+#endif
+      bench_redraw("value", &value);
+      bench_redraw("caption", &caption);
+    }
+    else if (strcmp(line, "bench style") == 0) {
+      bench_styles();
+    }
+    else if (strcmp(line, "prof reset") == 0) {
+      profiler.reset();
+    }
+  }
 }
+#endif
 
 static void lv_tick_task(void)
 {
@@ -442,6 +858,19 @@ static void build_screen() {
   lv_obj_add_style(screen, 0, &screen_st);
 }
 
+#if DASHBOARD
+// All captions and values in one object, on top of the bodies
+static void build_dashboard_mainscreen() {
+  dashboard.create(body_main, &text_st);
+
+  wl_value.bind(dashboard, tabBody, 70, 10, "Water Level Status: ", 212, 0, "");
+  temp_value.bind(dashboard, tabBody, 70, 30, "Temperature: ", 178, 1, "°C");
+  ph_value.bind(dashboard, phBody, 8, 8, "Current pH Value: ", 142, 2, "");
+  ph_target_value.bind(dashboard, phBody, 224, 8, "Target pH Value: ", 352, 1, "");
+  ec_value.bind(dashboard, ecBody, 8, 8, "Current EC Value: ", 142, 2, " mS/cm");
+  ec_target_value.bind(dashboard, ecBody, 224, 8, "Target EC Value: ", 352, 1, " mS/cm");
+}
+#else
 static void build_text_mainscreen() {
   // Water Level text
   WL_text = lv_label_create(tabBody, NULL);
@@ -450,6 +879,7 @@ static void build_text_mainscreen() {
   // Current Water Level value text
   WL_text_val = lv_label_create(tabBody, NULL);
   create_val_text(WL_text_val, tabBody, 212, 10);
+  wl_value.bind(WL_text_val, 0, "");
 
   // Temperature text
   temp_text = lv_label_create(tabBody, NULL);
@@ -458,6 +888,7 @@ static void build_text_mainscreen() {
   // Current Temperature value text
   temp_text_val = lv_label_create(tabBody, NULL);
   create_val_text(temp_text_val, tabBody, 178, 30);
+  temp_value.bind(temp_text_val, 1, "°C");
 
   // Current pH Text
   pH_text = lv_label_create(phBody, NULL);
@@ -466,6 +897,7 @@ static void build_text_mainscreen() {
   // Current pH Value Text 
   pH_text_val = lv_label_create(phBody, NULL);
   create_val_text(pH_text_val, phBody, 142, 8);
+  ph_value.bind(pH_text_val, 2, "");
 
   // Target pH Text
   pH_text_target = lv_label_create(phBody, NULL);
@@ -474,6 +906,7 @@ static void build_text_mainscreen() {
   // Target pH Value Text 
   pH_text_target_val = lv_label_create(phBody, NULL);
   create_val_text(pH_text_target_val, phBody, 352, 8);
+  ph_target_value.bind(pH_text_target_val, 1, "");
 
   // Current EC Text
   EC_text = lv_label_create(ecBody, NULL);
@@ -482,6 +915,7 @@ static void build_text_mainscreen() {
   // Current EC Value Text
   EC_text_val = lv_label_create(ecBody, NULL);
   create_val_text(EC_text_val, ecBody, 142, 8);
+  ec_value.bind(EC_text_val, 2, " mS/cm");
 
   // Target EC Text
   EC_text_target = lv_label_create(ecBody, NULL);
@@ -490,7 +924,19 @@ static void build_text_mainscreen() {
   // Target EC Value Text
   EC_text_target_val = lv_label_create(ecBody, NULL);
   create_val_text(EC_text_target_val, ecBody, 352, 8);
+  ec_target_value.bind(EC_text_target_val, 1, " mS/cm");
+}
+
+// Captions never change once laid out, swap them for pre-rendered copies
+static void build_chrome_cache_mainscreen() {
+  WL_text = chrome_cache_label(WL_text);
+  temp_text = chrome_cache_label(temp_text);
+  pH_text = chrome_cache_label(pH_text);
+  pH_text_target = chrome_cache_label(pH_text_target);
+  EC_text = chrome_cache_label(EC_text);
+  EC_text_target = chrome_cache_label(EC_text_target);
 }
+#endif
 
 static void build_text_settings() {
   // Water Level text
@@ -520,23 +966,17 @@ static void build_chart_mainscreen() {
   lv_obj_set_size(phChart, 444, 80);
   lv_obj_align(phChart, NULL, LV_ALIGN_IN_BOTTOM_RIGHT, -4, -4);
   lv_chart_set_type(phChart, LV_CHART_TYPE_COLUMN);
+  lv_chart_set_update_mode(phChart, LV_CHART_UPDATE_MODE_CIRCULAR);
 
   lv_chart_set_range(phChart, ph_min * 10, ph_max * 10);
   lv_chart_set_y_tick_texts(phChart, "4\n5\n6\n7\n8", 0, LV_CHART_AXIS_DRAW_LAST_TICK | LV_CHART_AXIS_INVERSE_LABELS_ORDER);
   lv_chart_set_y_tick_length(phChart, 4, 0);
 
   // Stylelizing Chart
-  lv_obj_set_style_local_bg_opa(phChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-  lv_obj_set_style_local_border_opa(phChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_add_style(phChart, LV_CHART_PART_BG, &chart_bg_st);
+  lv_obj_add_style(phChart, LV_CHART_PART_SERIES_BG, &chart_div_st);
+  lv_obj_add_style(phChart, LV_CHART_PART_SERIES, &chart_series_st);
   lv_chart_set_div_line_count(phChart, ph_max - ph_min - 1, 0);
-  lv_obj_set_style_local_pad_left(phChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, 32);
-  lv_obj_set_style_local_line_opa(phChart, LV_CHART_PART_SERIES_BG, LV_STATE_DEFAULT, LV_OPA_20);
-
-  // Fade effect 
-  lv_obj_set_style_local_bg_opa(phChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, LV_OPA_50);
-  lv_obj_set_style_local_bg_grad_dir(phChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, LV_GRAD_DIR_VER);
-  lv_obj_set_style_local_bg_main_stop(phChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, 255);   
-  lv_obj_set_style_local_bg_grad_stop(phChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, 32);     
 
   lv_chart_set_point_count(phChart, points);
   lv_obj_set_state(phChart, LV_STATE_DISABLED);
@@ -552,24 +992,17 @@ static void build_chart_mainscreen() {
   lv_obj_set_size(ecChart, 444, 80);
   lv_obj_align(ecChart, NULL, LV_ALIGN_IN_BOTTOM_RIGHT, -4, -4);
   lv_chart_set_type(ecChart, LV_CHART_TYPE_COLUMN);
+  lv_chart_set_update_mode(ecChart, LV_CHART_UPDATE_MODE_CIRCULAR);
 
   lv_chart_set_range(ecChart, ec_min, ec_max * 10);
   lv_chart_set_y_tick_texts(ecChart, "0\n1\n2\n3\n4", 0, LV_CHART_AXIS_DRAW_LAST_TICK | LV_CHART_AXIS_INVERSE_LABELS_ORDER);
   lv_chart_set_y_tick_length(ecChart, 4, 0);
 
   // Stylelizing Chart
-  lv_obj_set_style_local_bg_opa(ecChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-  lv_obj_set_style_local_border_opa(ecChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_add_style(ecChart, LV_CHART_PART_BG, &chart_bg_st);
+  lv_obj_add_style(ecChart, LV_CHART_PART_SERIES_BG, &chart_div_st);
+  lv_obj_add_style(ecChart, LV_CHART_PART_SERIES, &chart_series_st);
   lv_chart_set_div_line_count(ecChart, ec_max - ec_min - 1, 0);
-  lv_obj_set_style_local_pad_left(ecChart, LV_CHART_PART_BG, LV_STATE_DEFAULT, 32);
-
-  // Fade effect 
-  lv_obj_set_style_local_bg_opa(ecChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, LV_OPA_50);
-  lv_obj_set_style_local_bg_grad_dir(ecChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, LV_GRAD_DIR_VER);
-  lv_obj_set_style_local_bg_main_stop(ecChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, 255);   
-  lv_obj_set_style_local_bg_grad_stop(ecChart, LV_CHART_PART_SERIES, LV_STATE_DEFAULT, 32);     
-
-  lv_obj_set_style_local_line_opa(ecChart, LV_CHART_PART_SERIES_BG, LV_STATE_DEFAULT, LV_OPA_20);
 
   lv_chart_set_point_count(ecChart, points);
   lv_obj_set_state(ecChart, LV_STATE_DISABLED);
@@ -616,10 +1049,13 @@ static void build_body_mainscreen() {
 static void build_body_splashscreen() {
   
   // Splashscreen object
-  splashscreen_main = lv_obj_create(screen, NULL);
+  splashscreen = lv_obj_create(NULL, NULL);
+  lv_obj_add_style(splashscreen, 0, &screen_st);
+
+  splashscreen_main = lv_obj_create(splashscreen, NULL);
   lv_obj_add_style(splashscreen_main, 0, &screen_st);
   lv_obj_set_size(splashscreen_main, lcd.width() + 8, lcd.height() + 8);
-  lv_obj_align(splashscreen_main, screen, LV_ALIGN_IN_TOP_LEFT, -4, -4);
+  lv_obj_align(splashscreen_main, splashscreen, LV_ALIGN_IN_TOP_LEFT, -4, -4);
   lv_obj_set_state(splashscreen_main, LV_STATE_DISABLED);
 
   LV_IMG_DECLARE(icon);
@@ -631,6 +1067,7 @@ static void build_body_splashscreen() {
 static void switch_pumps_event(lv_obj_t * btn, lv_event_t e){
 if(e == LV_EVENT_VALUE_CHANGED) {
     THRESHOLD.PUMP = !(THRESHOLD.PUMP);
+    sensorLink.setThreshold(THRESHOLD);
   }
 }
 
@@ -677,9 +1114,34 @@ static void button_chart_refresh_event(lv_obj_t * btn, lv_event_t e)
     for(int i=0; i<points; i++){
       ec_ser->points[i] = ec_min  * 10;
     }
+    ph_ser->start_point = 0;
+    ec_ser->start_point = 0;
+    chart_back = 0;
+
+    ph_rollup.clear();
+    ec_rollup.clear();
+
+    invalidate_chart_series(phChart);
+    invalidate_chart_series(ecChart);
+  }
+}
+
+// Page the charts one window back in the history, or towards live
+static void button_chart_older_event(lv_obj_t * btn, lv_event_t e)
+{
+  if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
+    uint16_t back = chart_back + points;
+    chart_back = back < chart_back_max() ? back : chart_back_max();
+    reload_charts();
   }
+}
 
-  delay_current = 0;
+static void button_chart_newer_event(lv_obj_t * btn, lv_event_t e)
+{
+  if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
+    chart_back = chart_back > points ? chart_back - points : 0;
+    reload_charts();
+  }
 }
 
 static void build_buttons_mainscreen(){
@@ -689,6 +1151,8 @@ static void build_buttons_mainscreen(){
   lv_obj_set_size(settings_btn, 40, 40);
   lv_obj_align(settings_btn, NULL, LV_ALIGN_IN_RIGHT_MID, -8, 2);
 
+  router.link(settings_btn, SCREEN_SETTINGS);
+
   lv_obj_t *settings_btn_st = lv_label_create(settings_btn, NULL); 
   lv_label_set_text(settings_btn_st, LV_SYMBOL_SETTINGS); 
 
@@ -701,6 +1165,23 @@ static void build_buttons_mainscreen(){
   lv_obj_t *refresh_btn_st = lv_label_create(refresh_btn, NULL); 
   lv_label_set_text(refresh_btn_st, LV_SYMBOL_REFRESH); 
 
+  // Chart History Buttons
+  older_btn = lv_btn_create(tabBody, NULL);
+  lv_obj_set_size(older_btn, 32, 32);
+  lv_obj_align(older_btn, NULL, LV_ALIGN_CENTER, 48, 2);
+  lv_obj_set_event_cb(older_btn, button_chart_older_event);
+
+  lv_obj_t *older_btn_st = lv_label_create(older_btn, NULL); 
+  lv_label_set_text(older_btn_st, LV_SYMBOL_LEFT); 
+
+  newer_btn = lv_btn_create(tabBody, NULL);
+  lv_obj_set_size(newer_btn, 32, 32);
+  lv_obj_align(newer_btn, NULL, LV_ALIGN_CENTER, 88, 2);
+  lv_obj_set_event_cb(newer_btn, button_chart_newer_event);
+
+  lv_obj_t *newer_btn_st = lv_label_create(newer_btn, NULL); 
+  lv_label_set_text(newer_btn_st, LV_SYMBOL_RIGHT); 
+
   // pH Chart Button
   ph_btn = lv_btn_create(phBody, NULL);
   lv_obj_set_size(ph_btn, 32, 16);
@@ -728,6 +1209,7 @@ static void build_buttons_settings(){
   settings_cls_btn = lv_btn_create(tabBody_st, NULL);
   lv_obj_set_size(settings_cls_btn, 40, 40);
   lv_obj_align(settings_cls_btn, NULL, LV_ALIGN_IN_RIGHT_MID, -10, 2);
+  router.link(settings_cls_btn, SCREEN_MAIN);
 
   lv_obj_t *label_cls_st = lv_label_create(settings_cls_btn, NULL); 
   lv_label_set_text(label_cls_st, LV_SYMBOL_HOME); 
@@ -735,13 +1217,16 @@ static void build_buttons_settings(){
 
 static void build_body_settings() {
 
+  // Settings screen object
+  screen_settings = lv_obj_create(NULL, NULL);
+  lv_obj_add_style(screen_settings, 0, &screen_st);
+
   // Main body object
-  body_settings = lv_obj_create(screen, NULL);
+  body_settings = lv_obj_create(screen_settings, NULL);
   lv_obj_add_style(body_settings, 0, &screen_st);
   lv_obj_set_size(body_settings, lcd.width() + 8, lcd.height() + 8);
-  lv_obj_align(body_settings, screen, LV_ALIGN_IN_TOP_LEFT, -4, -4);
+  lv_obj_align(body_settings, screen_settings, LV_ALIGN_IN_TOP_LEFT, -4, -4);
   lv_obj_set_state(body_settings, LV_STATE_DISABLED);
-  lv_obj_set_pos(body_settings, 0, -(lcd.height() + 8));
 
   // Settings parameters Object
   settingsParam_ph = lv_obj_create(body_settings, NULL);
@@ -783,7 +1268,9 @@ static void spinbox_ph_increment_event(lv_obj_t * btn, lv_event_t e)
 {
     if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
         lv_spinbox_increment(spinbox_ph);
-        THRESHOLD.target_ph = ((double)lv_spinbox_get_value(spinbox_ph)) / 10;
+        PROBE_CHANGED(spinbox_ph);
+        THRESHOLD.target_ph = lv_spinbox_get_value(spinbox_ph) * (MILLI_ONE / 10);
+        sensorLink.setThreshold(THRESHOLD);
     }
 }
 
@@ -791,7 +1278,9 @@ static void spinbox_ph_decrement_event(lv_obj_t * btn, lv_event_t e)
 {
     if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
         lv_spinbox_decrement(spinbox_ph);
-        THRESHOLD.target_ph = ((double)lv_spinbox_get_value(spinbox_ph)) / 10;
+        PROBE_CHANGED(spinbox_ph);
+        THRESHOLD.target_ph = lv_spinbox_get_value(spinbox_ph) * (MILLI_ONE / 10);
+        sensorLink.setThreshold(THRESHOLD);
     }
 }
 
@@ -799,7 +1288,9 @@ static void spinbox_ec_increment_event(lv_obj_t * btn, lv_event_t e)
 {
     if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
         lv_spinbox_increment(spinbox_ec);
-        THRESHOLD.target_ec = ((double)lv_spinbox_get_value(spinbox_ec)) / 10;
+        PROBE_CHANGED(spinbox_ec);
+        THRESHOLD.target_ec = lv_spinbox_get_value(spinbox_ec) * (MILLI_ONE / 10);
+        sensorLink.setThreshold(THRESHOLD);
     }
 }
 
@@ -807,7 +1298,9 @@ static void spinbox_ec_decrement_event(lv_obj_t * btn, lv_event_t e)
 {
     if(e == LV_EVENT_SHORT_CLICKED || e == LV_EVENT_LONG_PRESSED_REPEAT) {
         lv_spinbox_decrement(spinbox_ec);
-        THRESHOLD.target_ec = ((double)lv_spinbox_get_value(spinbox_ec)) / 10; 
+        PROBE_CHANGED(spinbox_ec);
+        THRESHOLD.target_ec = lv_spinbox_get_value(spinbox_ec) * (MILLI_ONE / 10);
+        sensorLink.setThreshold(THRESHOLD);
     }
 }
 
@@ -822,31 +1315,10 @@ static void dropdown_change_delay_event(lv_obj_t * obj, lv_event_t event)
 {
     if(event == LV_EVENT_VALUE_CHANGED) {
         delay_option = lv_dropdown_get_selected(obj);
-        delay_current = 0;
-        total_ph = 0;
-        total_ec = 0;
-
-        if (delay_option == 0){
-          delay_ms = 1000;
-        }
-        else if (delay_option == 1){
-          delay_ms = 10000;
-        }
-        else if (delay_option == 2){
-          delay_ms = 60000;
-        }
-        else if (delay_option == 3){
-          delay_ms = 600000;
-        }
-        else if (delay_option == 4){
-          delay_ms = 1800000;
-        }
-        else if (delay_option == 5){
-          delay_ms = 3600000;
-        }
-        else {
-          delay_ms = 7200000;
-        }
+        chart_back = 0;
+
+        // Every interval is already rolled up, redraw from it straight away
+        reload_charts();
     }
 }
 
@@ -854,7 +1326,7 @@ static void build_widgets_settings(){
   // Spinbox for pH
   spinbox_ph = lv_spinbox_create(settingsParam_ph, NULL);
   lv_spinbox_set_range(spinbox_ph, ph_min * 10, ph_max * 10);
-  lv_spinbox_set_value(spinbox_ph, THRESHOLD.target_ph*10);
+  lv_spinbox_set_value(spinbox_ph, milli_round(THRESHOLD.target_ph, 1));
   lv_spinbox_set_digit_format(spinbox_ph, 2, 1);
   lv_spinbox_step_prev(spinbox_ph);
   lv_obj_set_width(spinbox_ph, 40);
@@ -866,18 +1338,19 @@ static void build_widgets_settings(){
   lv_obj_set_size(btn_ph, h, h);
   lv_obj_align(btn_ph, spinbox_ph, LV_ALIGN_OUT_RIGHT_MID, 5, 0);
   lv_theme_apply(btn_ph, LV_THEME_SPINBOX_BTN);
-  lv_obj_set_style_local_value_str(btn_ph, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_SYMBOL_PLUS);
+  lv_obj_add_style(btn_ph, LV_BTN_PART_MAIN, &btn_plus_st);
   lv_obj_set_event_cb(btn_ph, spinbox_ph_increment_event);
 
   btn_ph = lv_btn_create(settingsParam_ph, btn_ph);
   lv_obj_align(btn_ph, spinbox_ph, LV_ALIGN_OUT_LEFT_MID, -5, 0);
   lv_obj_set_event_cb(btn_ph, spinbox_ph_decrement_event);
-  lv_obj_set_style_local_value_str(btn_ph, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_SYMBOL_MINUS);
+  lv_obj_remove_style(btn_ph, LV_BTN_PART_MAIN, &btn_plus_st);
+  lv_obj_add_style(btn_ph, LV_BTN_PART_MAIN, &btn_minus_st);
 
   // Spinbox for EC
   spinbox_ec = lv_spinbox_create(settingsParam_ec, NULL);
   lv_spinbox_set_range(spinbox_ec, ec_min * 10, ec_max * 10);
-  lv_spinbox_set_value(spinbox_ec, THRESHOLD.target_ec*10);
+  lv_spinbox_set_value(spinbox_ec, milli_round(THRESHOLD.target_ec, 1));
   lv_spinbox_set_digit_format(spinbox_ec, 2, 1);
   lv_spinbox_step_prev(spinbox_ec);
   lv_obj_set_width(spinbox_ec, 40);
@@ -887,13 +1360,14 @@ static void build_widgets_settings(){
   lv_obj_set_size(btn_ec, h, h);
   lv_obj_align(btn_ec, spinbox_ec, LV_ALIGN_OUT_RIGHT_MID, 5, 0);
   lv_theme_apply(btn_ec, LV_THEME_SPINBOX_BTN);
-  lv_obj_set_style_local_value_str(btn_ec, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_SYMBOL_PLUS);
+  lv_obj_add_style(btn_ec, LV_BTN_PART_MAIN, &btn_plus_st);
   lv_obj_set_event_cb(btn_ec, spinbox_ec_increment_event);
 
   btn_ec = lv_btn_create(settingsParam_ec, btn_ec);
   lv_obj_align(btn_ec, spinbox_ec, LV_ALIGN_OUT_LEFT_MID, -5, 0);
   lv_obj_set_event_cb(btn_ec, spinbox_ec_decrement_event);
-  lv_obj_set_style_local_value_str(btn_ec, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_SYMBOL_MINUS);
+  lv_obj_remove_style(btn_ec, LV_BTN_PART_MAIN, &btn_plus_st);
+  lv_obj_add_style(btn_ec, LV_BTN_PART_MAIN, &btn_minus_st);
 
   // Drop down list for chart delay
   lv_obj_t * dropdown_delay = lv_dropdown_create(settingsParam_delay, NULL);
@@ -943,10 +1417,37 @@ static void build_style_mainscreen() {
   lv_style_set_border_color(&body_st, LV_STATE_DEFAULT, lv_color_hex(0x26264C));
   lv_style_set_bg_color(&body_st, LV_STATE_DEFAULT, lv_color_hex(0x26264C));
   //lv_style_set_text_font(&body_st, LV_STATE_DEFAULT, LV_FONT_MONTSERRAT_28);
+
+  // Label style
+  lv_style_init(&text_st);
+  lv_style_set_text_color(&text_st, LV_STATE_DEFAULT, LV_COLOR_WHITE);
+
+  // Chart styles: transparent background, faint division lines, faded columns
+  lv_style_init(&chart_bg_st);
+  lv_style_set_bg_opa(&chart_bg_st, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_style_set_border_opa(&chart_bg_st, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_style_set_pad_left(&chart_bg_st, LV_STATE_DEFAULT, 32);
+
+  lv_style_init(&chart_div_st);
+  lv_style_set_line_opa(&chart_div_st, LV_STATE_DEFAULT, LV_OPA_20);
+
+  lv_style_init(&chart_series_st);
+  lv_style_set_bg_opa(&chart_series_st, LV_STATE_DEFAULT, LV_OPA_50);
+  lv_style_set_bg_grad_dir(&chart_series_st, LV_STATE_DEFAULT, LV_GRAD_DIR_VER);
+  lv_style_set_bg_main_stop(&chart_series_st, LV_STATE_DEFAULT, 255);
+  lv_style_set_bg_grad_stop(&chart_series_st, LV_STATE_DEFAULT, 32);
+
+  // Spinbox step buttons
+  lv_style_init(&btn_plus_st);
+  lv_style_set_value_str(&btn_plus_st, LV_STATE_DEFAULT, LV_SYMBOL_PLUS);
+
+  lv_style_init(&btn_minus_st);
+  lv_style_set_value_str(&btn_minus_st, LV_STATE_DEFAULT, LV_SYMBOL_MINUS);
 }
 
 static void initialize() {
   Wire.begin(18, 19);
+  i2cBus.begin(); // Touch and sensor tasks share the bus
   Serial.begin(115200);
   lv_init();
   // Setup tick hook for lv_tick_task
@@ -955,6 +1456,9 @@ static void initialize() {
   // Enable TFT
   lcd.begin();
   lcd.setRotation(1);
+  lcd.initDMA();
+  lcd.setSwapBytes(LV_COLOR_16_SWAP == 0); // Swapped builds render in wire order already
+  lcd.startWrite(); // SPI bus is owned by the display, keep it for DMA
 
   // Enable Backlight
   pinMode(TFT_BL, OUTPUT);
@@ -965,9 +1469,21 @@ static void initialize() {
 
   // Start TouchScreen
   touchScreen.begin();
+#ifdef PIN_TOUCH_INT
+  touchScreen.enableInterrupt(PIN_TOUCH_INT); // No I2C polling while nobody touches the panel
+#endif
+  touchSampler.notify(xTaskGetCurrentTaskHandle()); // initialize() runs in the loop task
+  touchSampler.begin(0); // loop() and LVGL run on core 1
+  sensorLink.begin(0, THRESHOLD); // I2C waits no longer hold up lv_task_handler()
+#if PROFILER && defined(ARDUINO_ARCH_ESP32)
+  coreLoad.begin();
+#endif
+#if LOG_LEVEL > LOG_LEVEL_NONE
+  logger.begin(0);
+#endif
 
   // Display Buffer
-  lv_disp_buf_init(&disp_buf, buf, NULL, LV_HOR_RES_MAX * 10);
+  lv_disp_buf_init(&disp_buf, buf_1, buf_2, LV_HOR_RES_MAX * 10);
 
   // Init Display
   lv_disp_drv_init(&disp_drv);
@@ -975,11 +1491,13 @@ static void initialize() {
   disp_drv.ver_res = 320;
   disp_drv.flush_cb = disp_flush;
   disp_drv.buffer = &disp_buf;
-  lv_disp_drv_register(&disp_drv);
+  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+  PROF_TASK(_lv_disp_get_refr_task(disp), PROF_RENDER);
 
   // Init Touchscreen
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = input_read;
-  lv_indev_drv_register(&indev_drv);
+  touch_indev = lv_indev_drv_register(&indev_drv);
+  PROF_TASK(touch_indev->driver.read_task, "indev");
 }